@@ -0,0 +1,148 @@
+#include <huffman/HuffmanDictionary.hpp>
+#include <benchmark/benchmark.h>
+
+#include "Corpus.hpp"
+
+using namespace huffman;
+
+namespace
+{
+
+// Total size of the messages of every batch
+constexpr size_t batch_bytes = size_t{1} << 20;
+
+/**
+ * Text split into messages of the same size, with a dictionary made from all of it
+ */
+struct Batch
+{
+	std::vector<char> text;
+	HuffmanDictionary dictionary;
+	std::vector<HuffmanDictionary::Message> messages;
+	std::vector<size_t> sizes;
+
+	explicit Batch(size_t message_size)
+		: text{corpus::text(batch_bytes)}, dictionary{text.data(), text.size()}, messages{}, sizes(batch_bytes / message_size, message_size)
+	{
+		for(size_t i = 0; i < sizes.size(); i++)
+		{
+			messages.push_back({text.data() + i*message_size, message_size});
+		}
+	}
+
+	~Batch();
+};
+
+// Out of line, so that the destructor is not too big to be inlined
+Batch::~Batch() = default;
+
+void set_counters(benchmark::State& state, const Batch& batch)
+{
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(batch_bytes));
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch.messages.size()));
+	state.counters["batches_per_second"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+
+// One encode() call per message, for comparison with encode_batch()
+void HuffmanDictionary_encode_messages(benchmark::State& state)
+{
+	Batch batch(static_cast<size_t>(state.range(0)));
+	std::vector<char> output(batch_bytes * 2);
+
+	for(auto _ : state)
+	{
+		char* dst = output.data();
+		for(const auto& message : batch.messages)
+		{
+			auto[bytes_read, bits_written] = batch.dictionary.encode(message.data, message.size, dst, message.size * 2, 0);
+			dst += (bits_written + 7) / 8;
+		}
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	set_counters(state, batch);
+}
+
+void HuffmanDictionary_encode_batch(benchmark::State& state)
+{
+	Batch batch(static_cast<size_t>(state.range(0)));
+	std::vector<char> output(batch.dictionary.encode_batch_bound(batch.messages.data(), batch.messages.size()));
+	std::vector<size_t> encoded_sizes(batch.messages.size());
+
+	for(auto _ : state)
+	{
+		batch.dictionary.encode_batch(batch.messages.data(), batch.messages.size(), output.data(), output.size(),
+									encoded_sizes.data(), static_cast<size_t>(state.range(1)));
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	set_counters(state, batch);
+}
+
+/**
+ * @brief				encode the messages of the batch and point them to their encoded version
+ */
+std::vector<char> encode_messages(Batch& batch)
+{
+	std::vector<char> encoded(batch.dictionary.encode_batch_bound(batch.messages.data(), batch.messages.size()));
+	std::vector<size_t> encoded_sizes(batch.messages.size());
+	batch.dictionary.encode_batch(batch.messages.data(), batch.messages.size(), encoded.data(), encoded.size(), encoded_sizes.data(), 1);
+
+	const char* begin = encoded.data();
+	for(size_t i = 0; i < batch.messages.size(); i++)
+	{
+		batch.messages[i] = {begin, encoded_sizes[i]};
+		begin += encoded_sizes[i];
+	}
+
+	return encoded;
+}
+
+// One decode() call per message, for comparison with decode_batch()
+void HuffmanDictionary_decode_messages(benchmark::State& state)
+{
+	Batch batch(static_cast<size_t>(state.range(0)));
+	std::vector<char> encoded = encode_messages(batch);
+	std::vector<char> output(batch_bytes);
+
+	for(auto _ : state)
+	{
+		char* dst = output.data();
+		for(size_t i = 0; i < batch.messages.size(); i++)
+		{
+			batch.dictionary.decode(batch.messages[i].data, batch.messages[i].size, dst, batch.sizes[i], 0);
+			dst += batch.sizes[i];
+		}
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	set_counters(state, batch);
+}
+
+void HuffmanDictionary_decode_batch(benchmark::State& state)
+{
+	Batch batch(static_cast<size_t>(state.range(0)));
+	std::vector<char> encoded = encode_messages(batch);
+	std::vector<char> output(batch_bytes);
+
+	for(auto _ : state)
+	{
+		batch.dictionary.decode_batch(batch.messages.data(), batch.messages.size(), output.data(), output.size(),
+									batch.sizes.data(), static_cast<size_t>(state.range(1)));
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	set_counters(state, batch);
+}
+
+} // namespace
+
+// Message size in bytes (and number of threads)
+BENCHMARK(HuffmanDictionary_encode_messages)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK(HuffmanDictionary_encode_batch)->ArgsProduct({{16, 64, 256, 1024}, {1, 4}})->UseRealTime();
+BENCHMARK(HuffmanDictionary_decode_messages)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK(HuffmanDictionary_decode_batch)->ArgsProduct({{16, 64, 256, 1024}, {1, 4}})->UseRealTime();
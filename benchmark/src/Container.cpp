@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+#include <huffman/Container.hpp>
+#include <huffman/HuffmanDictionary.hpp>
+#include <vector>
+
+#include "Corpus.hpp"
+
+using namespace huffman;
+
+namespace
+{
+
+void container_compress(benchmark::State& state)
+{
+	static const std::vector<char> text = corpus::text(size_t{1} << 24);
+	std::vector<char> output(compress_bound(text.size(), HuffmanDictionary::default_block_size));
+
+	for(auto _ : state)
+	{
+		compress(text.data(), text.size(), output.data(), output.size(),
+				HuffmanDictionary::default_block_size, static_cast<size_t>(state.range(0)));
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+
+void container_decompress(benchmark::State& state)
+{
+	static const std::vector<char> text = corpus::text(size_t{1} << 24);
+	std::vector<char> compressed(compress_bound(text.size(), HuffmanDictionary::default_block_size));
+	compressed.resize(compress(text.data(), text.size(), compressed.data(), compressed.size(), HuffmanDictionary::default_block_size, 0));
+	std::vector<char> output(decompressed_size(compressed.data(), compressed.size()));
+
+	for(auto _ : state)
+	{
+		decompress(compressed.data(), compressed.size(), output.data(), output.size(), static_cast<size_t>(state.range(0)));
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+
+// Single thread, for the block types of data that does not compress well
+void container_compress_corpus(benchmark::State& state, std::vector<char>(*generate)(size_t))
+{
+	std::vector<char> data = generate(size_t{1} << 22);
+	std::vector<char> output(compress_bound(data.size(), HuffmanDictionary::default_block_size));
+	size_t compressed_size = 0;
+
+	for(auto _ : state)
+	{
+		compressed_size = compress(data.data(), data.size(), output.data(), output.size(), HuffmanDictionary::default_block_size, 1);
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+	state.counters["ratio"] = static_cast<double>(compressed_size) / static_cast<double>(data.size());
+}
+
+void container_decompress_corpus(benchmark::State& state, std::vector<char>(*generate)(size_t))
+{
+	std::vector<char> data = generate(size_t{1} << 22);
+	std::vector<char> compressed(compress_bound(data.size(), HuffmanDictionary::default_block_size));
+	compressed.resize(compress(data.data(), data.size(), compressed.data(), compressed.size(), HuffmanDictionary::default_block_size, 1));
+	std::vector<char> output(data.size());
+
+	for(auto _ : state)
+	{
+		decompress(compressed.data(), compressed.size(), output.data(), output.size(), 1);
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+
+} // namespace
+
+BENCHMARK(container_compress)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+BENCHMARK(container_decompress)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+BENCHMARK_CAPTURE(container_compress_corpus, text, corpus::text);
+BENCHMARK_CAPTURE(container_compress_corpus, uniform, corpus::uniform);
+BENCHMARK_CAPTURE(container_compress_corpus, runs, corpus::runs);
+BENCHMARK_CAPTURE(container_decompress_corpus, text, corpus::text);
+BENCHMARK_CAPTURE(container_decompress_corpus, uniform, corpus::uniform);
+BENCHMARK_CAPTURE(container_decompress_corpus, runs, corpus::runs);
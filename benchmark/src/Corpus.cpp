@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <array>
+#include <random>
+#include <string_view>
+
+#include "Corpus.hpp"
+
+namespace corpus
+{
+
+std::vector<char> text(size_t size)
+{
+	static constexpr std::array<std::string_view, 61> words = {
+		"the", "of", "and", "to", "in", "a", "is", "that", "for", "it", "as", "was", "with", "be", "by",
+		"on", "not", "he", "this", "are", "or", "his", "from", "at", "which", "but", "have", "an", "had",
+		"they", "you", "were", "their", "one", "all", "we", "can", "her", "has", "there", "been", "if",
+		"more", "when", "will", "would", "who", "so", "no", "compression", "dictionary", "huffman",
+		"Request", "ERROR", "200", "GET", "/index.html", "user_id=", "timeout", "\t", "\"",
+	};
+
+	std::mt19937 generator{42};
+	std::geometric_distribution<size_t> word_index{0.15};
+
+	std::vector<char> result;
+	result.reserve(size + 32);
+	while(result.size() < size)
+	{
+		std::string_view word = words[std::min(word_index(generator), words.size()-1)];
+		std::string_view separator = (generator() % 12 == 0) ? ".\n" : " ";
+
+		result.insert(result.end(), word.begin(), word.end());
+		result.insert(result.end(), separator.begin(), separator.end());
+	}
+
+	result.resize(size);
+	return result;
+}
+
+std::vector<char> uniform(size_t size)
+{
+	std::mt19937 generator{42};
+	std::uniform_int_distribution<int> byte{0, 255};
+
+	std::vector<char> result(size);
+	for(char& c : result)
+	{
+		c = static_cast<char>(byte(generator));
+	}
+
+	return result;
+}
+
+std::vector<char> skewed(size_t size)
+{
+	std::mt19937 generator{42};
+	std::geometric_distribution<int> byte{0.05};
+
+	std::vector<char> result(size);
+	for(size_t i = 0; i < size; i++)
+	{
+		// Every byte once, so every benchmark builds a full tree
+		result[i] = static_cast<char>(i < 256 ? static_cast<int>(i) : std::min(byte(generator), 255));
+	}
+
+	return result;
+}
+
+std::vector<char> runs(size_t size)
+{
+	std::mt19937 generator{42};
+	std::uniform_int_distribution<int> byte{0, 255};
+	std::geometric_distribution<size_t> length{0.02};
+
+	std::vector<char> result;
+	result.reserve(size);
+	while(result.size() < size)
+	{
+		size_t run = std::min(length(generator) + 1, size - result.size());
+		result.insert(result.end(), run, static_cast<char>(byte(generator)));
+	}
+
+	return result;
+}
+
+std::vector<char> zipf(size_t size)
+{
+	std::array<double, 256> weights{};
+	for(size_t rank = 0; rank < weights.size(); rank++)
+	{
+		weights[rank] = 1.0 / static_cast<double>(rank + 1);
+	}
+
+	std::mt19937 generator{42};
+	std::discrete_distribution<int> rank{weights.begin(), weights.end()};
+
+	// Spread the common bytes over the byte values, like in real data
+	std::vector<char> result(size);
+	for(char& c : result)
+	{
+		c = static_cast<char>(rank(generator) * 167 % 256);
+	}
+
+	return result;
+}
+
+std::vector<char> single_byte(size_t size)
+{
+	return std::vector<char>(size, 'a');
+}
+
+} // namespace corpus
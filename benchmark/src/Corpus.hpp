@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace corpus
+{
+
+/**
+ * @brief				generate deterministic english-like text
+ * @param[in]	size	size of the text
+ */
+std::vector<char> text(size_t size);
+
+/**
+ * @brief				generate uniformly distributed random bytes
+ * @param[in]	size	size of the data
+ */
+std::vector<char> uniform(size_t size);
+
+/**
+ * @brief				generate random bytes with geometrically decreasing frequencies (all 256 bytes appear)
+ * @param[in]	size	size of the data (at least 256)
+ */
+std::vector<char> skewed(size_t size);
+
+/**
+ * @brief				generate runs of repeated bytes of random lengths, like binary telemetry
+ * @param[in]	size	size of the data
+ */
+std::vector<char> runs(size_t size);
+
+/**
+ * @brief				generate random bytes following Zipf's law (the k-th most common byte is k times rarer than the first)
+ * @param[in]	size	size of the data
+ */
+std::vector<char> zipf(size_t size);
+
+/**
+ * @brief				generate a single repeated byte
+ * @param[in]	size	size of the data
+ */
+std::vector<char> single_byte(size_t size);
+
+} // namespace corpus
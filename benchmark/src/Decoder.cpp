@@ -0,0 +1,157 @@
+#include <huffman/AdaptiveDecoder.hpp>
+#include <huffman/AdaptiveEncoder.hpp>
+#include <huffman/HuffmanDictionary.hpp>
+#include <decoder/ByteDecoder.hpp>
+#include <decoder/TableDecoder.hpp>
+#include <benchmark/benchmark.h>
+
+#include "Corpus.hpp"
+
+using namespace huffman;
+
+namespace
+{
+
+std::vector<char> encode(HuffmanDictionary& dictionary, const std::vector<char>& text)
+{
+	std::vector<char> encoded(text.size()*2);
+	dictionary.encode(text.data(), text.size(), encoded.data(), encoded.size(), 0);
+
+	return encoded;
+}
+
+void decoder_ByteDecoder(benchmark::State& state)
+{
+	std::vector<char> text = corpus::text(static_cast<size_t>(state.range(0)));
+	HuffmanDictionary dictionary(text.data(), text.size());
+	std::vector<char> encoded = encode(dictionary, text);
+	std::vector<char> output(text.size());
+	const HuffmanNode& root = dictionary.data();
+
+	for(auto _ : state)
+	{
+		decoder::ByteLoader loader(encoded.data(), encoded.size(), 0);
+		decoder::ByteDecoder decoder(loader, root);
+
+		for(char& byte : output)
+		{
+			byte = decoder.decode().first;
+		}
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void decoder_TableDecoder(benchmark::State& state)
+{
+	std::vector<char> text = corpus::text(static_cast<size_t>(state.range(0)));
+	HuffmanDictionary dictionary(text.data(), text.size());
+	std::vector<char> encoded = encode(dictionary, text);
+	std::vector<char> output(text.size());
+
+	for(auto _ : state)
+	{
+		decoder::BitReader reader(encoded.data(), encoded.size(), 0);
+		decoder::DecodeTable table(dictionary.tree());
+		decoder::TableDecoder decoder(reader, table);
+
+		decoder.decode(output.data(), output.size());
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void HuffmanDictionary_decode(benchmark::State& state, std::vector<char>(*generate)(size_t))
+{
+	std::vector<char> text = generate(static_cast<size_t>(state.range(0)));
+	HuffmanDictionary dictionary(text.data(), text.size());
+	std::vector<char> encoded = encode(dictionary, text);
+	std::vector<char> output(text.size());
+
+	for(auto _ : state)
+	{
+		dictionary.decode(encoded.data(), encoded.size(), output.data(), output.size(), 0);
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// Same corpora as HuffmanDictionary_decode, which it should beat on all of them
+void HuffmanDictionary_decode_interleaved(benchmark::State& state, std::vector<char>(*generate)(size_t))
+{
+	std::vector<char> text = generate(static_cast<size_t>(state.range(0)));
+	HuffmanDictionary dictionary(text.data(), text.size());
+	std::vector<char> encoded(dictionary.encode_interleaved_bound(text.size()));
+	encoded.resize(dictionary.encode_interleaved(text.data(), text.size(), encoded.data(), encoded.size()));
+	std::vector<char> output(text.size());
+
+	for(auto _ : state)
+	{
+		dictionary.decode_interleaved(encoded.data(), encoded.size(), output.data(), output.size());
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void HuffmanDictionary_decode_blocks(benchmark::State& state)
+{
+	static const std::vector<char> text = corpus::text(size_t{1} << 24);
+	HuffmanDictionary dictionary(text.data(), text.size());
+	std::vector<char> encoded(dictionary.encode_blocks_bound(text.size(), HuffmanDictionary::default_block_size));
+	encoded.resize(dictionary.encode_blocks(text.data(), text.size(), encoded.data(), encoded.size(), HuffmanDictionary::default_block_size, 0));
+	std::vector<char> output(text.size());
+
+	for(auto _ : state)
+	{
+		dictionary.decode_blocks(encoded.data(), encoded.size(), output.data(), output.size(), static_cast<size_t>(state.range(0)));
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+
+void AdaptiveDecoder_decode(benchmark::State& state)
+{
+	size_t rebuild_period = static_cast<size_t>(state.range(0));
+	std::vector<char> text = corpus::text(size_t{1} << 20);
+	std::vector<char> encoded(text.size() + 8);
+	AdaptiveEncoder encoder(rebuild_period);
+	auto[src_read, dst_written] = encoder.encode(text.data(), text.size(), encoded.data(), encoded.size());
+	encoded.resize(dst_written + encoder.finish(encoded.data() + dst_written, encoded.size() - dst_written));
+	std::vector<char> output(text.size());
+
+	for(auto _ : state)
+	{
+		AdaptiveDecoder decoder(rebuild_period);
+		decoder.decode(encoded.data(), encoded.size(), output.data(), output.size());
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+	state.counters["ratio"] = static_cast<double>(encoded.size()) / static_cast<double>(text.size());
+}
+
+} // namespace
+
+BENCHMARK(decoder_ByteDecoder)->Range(1<<10, 1<<20);
+BENCHMARK(decoder_TableDecoder)->Range(1<<10, 1<<20);
+BENCHMARK_CAPTURE(HuffmanDictionary_decode, text, corpus::text)->Range(1<<10, 1<<20);
+BENCHMARK_CAPTURE(HuffmanDictionary_decode, uniform, corpus::uniform)->Range(1<<10, 1<<20);
+BENCHMARK_CAPTURE(HuffmanDictionary_decode, zipf, corpus::zipf)->Range(1<<10, 1<<20);
+BENCHMARK_CAPTURE(HuffmanDictionary_decode, single_byte, corpus::single_byte)->Range(1<<10, 1<<20);
+BENCHMARK_CAPTURE(HuffmanDictionary_decode_interleaved, text, corpus::text)->Range(1<<10, 1<<20);
+BENCHMARK_CAPTURE(HuffmanDictionary_decode_interleaved, uniform, corpus::uniform)->Range(1<<10, 1<<20);
+BENCHMARK_CAPTURE(HuffmanDictionary_decode_interleaved, zipf, corpus::zipf)->Range(1<<10, 1<<20);
+BENCHMARK_CAPTURE(HuffmanDictionary_decode_interleaved, single_byte, corpus::single_byte)->Range(1<<10, 1<<20);
+BENCHMARK(HuffmanDictionary_decode_blocks)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+BENCHMARK(AdaptiveDecoder_decode)->RangeMultiplier(4)->Range(1<<10, 1<<16);
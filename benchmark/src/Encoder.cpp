@@ -0,0 +1,146 @@
+#include <huffman/AdaptiveEncoder.hpp>
+#include <huffman/HuffmanDictionary.hpp>
+#include <encoder/ByteWriter.hpp>
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include "Corpus.hpp"
+
+using namespace huffman;
+
+namespace
+{
+
+void encoder_ByteWriter(benchmark::State& state)
+{
+	// Code lengths from 1 to 13 bits, like in a typical dictionary
+	std::vector<std::pair<uint64_t, size_t>> codes(static_cast<size_t>(state.range(0)));
+	for(size_t i = 0; i < codes.size(); i++)
+	{
+		size_t length = i * 7 % 13 + 1;
+		codes[i] = {(i * 0x9e3779b97f4a7c15) & ((uint64_t{1} << length) - 1), length};
+	}
+
+	std::vector<char> output(codes.size() * 2);
+
+	for(auto _ : state)
+	{
+		encoder::ByteWriter writer(output.data(), output.size(), 0);
+		for(auto[code, length] : codes)
+		{
+			writer.write(code, length);
+		}
+
+		writer.flush();
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void HuffmanDictionary_encode(benchmark::State& state, std::vector<char>(*generate)(size_t))
+{
+	std::vector<char> text = generate(static_cast<size_t>(state.range(0)));
+	HuffmanDictionary dictionary(text.data(), text.size());
+	std::vector<char> output(text.size()*2);
+
+	for(auto _ : state)
+	{
+		dictionary.encode(text.data(), text.size(), output.data(), output.size(), 0);
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void HuffmanDictionary_encode_scatter_gather(benchmark::State& state)
+{
+	// 1 MiB of text in segments of the given size, encoded into the two halves of a ring buffer
+	std::vector<char> text = corpus::text(1<<20);
+	HuffmanDictionary dictionary(text.data(), text.size());
+	std::vector<std::span<const std::byte>> src;
+	for(std::span<const std::byte> rest = std::as_bytes(std::span{text}); !rest.empty(); rest = rest.subspan(src.back().size()))
+	{
+		src.push_back(rest.first(std::min(rest.size(), static_cast<size_t>(state.range(0)))));
+	}
+
+	std::vector<std::byte> output(text.size()*2);
+	std::array<std::span<std::byte>, 2> dst{std::span{output}.subspan(text.size()), std::span{output}.first(text.size())};
+
+	for(auto _ : state)
+	{
+		dictionary.encode(src, dst);
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+
+void HuffmanDictionary_encode_interleaved(benchmark::State& state)
+{
+	std::vector<char> text = corpus::text(static_cast<size_t>(state.range(0)));
+	HuffmanDictionary dictionary(text.data(), text.size());
+	std::vector<char> output(dictionary.encode_interleaved_bound(text.size()));
+
+	for(auto _ : state)
+	{
+		dictionary.encode_interleaved(text.data(), text.size(), output.data(), output.size());
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void HuffmanDictionary_encode_blocks(benchmark::State& state)
+{
+	static const std::vector<char> text = corpus::text(size_t{1} << 24);
+	HuffmanDictionary dictionary(text.data(), text.size());
+	std::vector<char> output(dictionary.encode_blocks_bound(text.size(), HuffmanDictionary::default_block_size));
+
+	for(auto _ : state)
+	{
+		dictionary.encode_blocks(text.data(), text.size(), output.data(), output.size(),
+								HuffmanDictionary::default_block_size, static_cast<size_t>(state.range(0)));
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+
+void AdaptiveEncoder_encode(benchmark::State& state)
+{
+	std::vector<char> text = corpus::text(size_t{1} << 20);
+	std::vector<char> output(text.size() + 8);
+
+	for(auto _ : state)
+	{
+		AdaptiveEncoder encoder(static_cast<size_t>(state.range(0)));
+		auto[src_read, dst_written] = encoder.encode(text.data(), text.size(), output.data(), output.size());
+		encoder.finish(output.data() + dst_written, output.size() - dst_written);
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+
+} // namespace
+
+BENCHMARK(encoder_ByteWriter)->Range(1<<10, 1<<20);
+BENCHMARK_CAPTURE(HuffmanDictionary_encode, text, corpus::text)->Range(1<<10, 1<<20);
+BENCHMARK_CAPTURE(HuffmanDictionary_encode, uniform, corpus::uniform)->Range(1<<10, 1<<20);
+BENCHMARK_CAPTURE(HuffmanDictionary_encode, zipf, corpus::zipf)->Range(1<<10, 1<<20);
+BENCHMARK_CAPTURE(HuffmanDictionary_encode, single_byte, corpus::single_byte)->Range(1<<10, 1<<20);
+BENCHMARK(HuffmanDictionary_encode_scatter_gather)->RangeMultiplier(8)->Range(64, 1<<15);
+BENCHMARK(HuffmanDictionary_encode_interleaved)->Range(1<<10, 1<<20);
+BENCHMARK(HuffmanDictionary_encode_blocks)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+BENCHMARK(AdaptiveEncoder_encode)->RangeMultiplier(4)->Range(1<<10, 1<<16);
@@ -0,0 +1,43 @@
+#include <histogram/Histogram.hpp>
+#include <benchmark/benchmark.h>
+
+#include "Corpus.hpp"
+
+using namespace huffman;
+
+namespace
+{
+
+void count_simple(histogram::byte_frequencies& frequencies, const char* src, size_t src_size)
+{
+	for(size_t i = 0; i < src_size; i++)
+	{
+		frequencies[static_cast<unsigned char>(src[i])]++;
+	}
+}
+
+void Histogram(benchmark::State& state, void(*count)(histogram::byte_frequencies&, const char*, size_t), std::vector<char>(*generate)(size_t))
+{
+	std::vector<char> data = generate(1 << 20);
+
+	for(auto _ : state)
+	{
+		histogram::byte_frequencies frequencies{};
+		count(frequencies, data.data(), data.size());
+
+		benchmark::DoNotOptimize(frequencies);
+	}
+
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(Histogram, simple/runs, count_simple, corpus::runs);
+BENCHMARK_CAPTURE(Histogram, simple/uniform, count_simple, corpus::uniform);
+BENCHMARK_CAPTURE(Histogram, generic/runs, histogram::count_generic, corpus::runs);
+BENCHMARK_CAPTURE(Histogram, generic/uniform, histogram::count_generic, corpus::uniform);
+#ifdef HUFFMAN_HISTOGRAM_AVX2
+BENCHMARK_CAPTURE(Histogram, avx2/runs, histogram::count_avx2, corpus::runs);
+BENCHMARK_CAPTURE(Histogram, avx2/uniform, histogram::count_avx2, corpus::uniform);
+#endif
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+#include <huffman/FrequencyAccumulator.hpp>
+#include <huffman/HuffmanDictionary.hpp>
+#include <benchmark/benchmark.h>
+
+#include "Corpus.hpp"
+
+using namespace huffman;
+
+namespace
+{
+
+void HuffmanDictionary_create(benchmark::State& state, std::vector<char>(*generate)(size_t))
+{
+	std::vector<char> data = generate(static_cast<size_t>(state.range(0)));
+	HuffmanDictionary dictionary;
+
+	for(auto _ : state)
+	{
+		dictionary.create(data.data(), data.size());
+
+		benchmark::DoNotOptimize(dictionary);
+	}
+
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void HuffmanDictionary_create_threads(benchmark::State& state)
+{
+	static const std::vector<char> data = corpus::text(size_t{1} << 25);
+	HuffmanDictionary dictionary;
+
+	for(auto _ : state)
+	{
+		dictionary.create(data.data(), data.size(), 0, static_cast<size_t>(state.range(0)));
+
+		benchmark::DoNotOptimize(dictionary);
+	}
+
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+
+// Rebuild with limited codes and a decode table, from the default resource (0) or a monotonic buffer (1)
+void HuffmanDictionary_rebuild_resource(benchmark::State& state)
+{
+	std::vector<char> data = corpus::text(1 << 12);
+	std::vector<char> encoded(data.size());
+	char byte;
+	alignas(std::max_align_t) static std::array<std::byte, 1 << 17> arena;
+
+	for(auto _ : state)
+	{
+		std::pmr::monotonic_buffer_resource buffer(arena.data(), arena.size());
+		HuffmanDictionary dictionary(state.range(0) ? &buffer : std::pmr::get_default_resource());
+		dictionary.create(data.data(), data.size(), 12);
+		dictionary.decode(encoded.data(), encoded.size(), &byte, 1, 0);
+
+		benchmark::DoNotOptimize(byte);
+	}
+}
+
+// Data arriving in chunks, with a dictionary needed only at the end
+constexpr size_t chunk_size = 4096;
+
+void HuffmanDictionary_create_part_chunks(benchmark::State& state)
+{
+	std::vector<char> data = corpus::text(static_cast<size_t>(state.range(0)));
+
+	for(auto _ : state)
+	{
+		HuffmanDictionary dictionary;
+		for(size_t i = 0; i < data.size(); i += chunk_size)
+		{
+			dictionary.create_part(data.data() + i, std::min(chunk_size, data.size() - i));
+		}
+
+		benchmark::DoNotOptimize(dictionary);
+	}
+
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void FrequencyAccumulator_add_chunks(benchmark::State& state)
+{
+	std::vector<char> data = corpus::text(static_cast<size_t>(state.range(0)));
+
+	for(auto _ : state)
+	{
+		FrequencyAccumulator accumulator;
+		for(size_t i = 0; i < data.size(); i += chunk_size)
+		{
+			accumulator.add(data.data() + i, std::min(chunk_size, data.size() - i));
+		}
+
+		HuffmanDictionary dictionary = accumulator.dictionary();
+		benchmark::DoNotOptimize(dictionary);
+	}
+
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(HuffmanDictionary_create, text, corpus::text)->Range(1<<8, 1<<16);
+BENCHMARK_CAPTURE(HuffmanDictionary_create, uniform, corpus::uniform)->Range(1<<8, 1<<16);
+BENCHMARK_CAPTURE(HuffmanDictionary_create, skewed, corpus::skewed)->Range(1<<8, 1<<16);
+BENCHMARK_CAPTURE(HuffmanDictionary_create, zipf, corpus::zipf)->Range(1<<8, 1<<16);
+BENCHMARK_CAPTURE(HuffmanDictionary_create, single_byte, corpus::single_byte)->Range(1<<8, 1<<16);
+BENCHMARK(HuffmanDictionary_create_threads)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+BENCHMARK(HuffmanDictionary_rebuild_resource)->Arg(0)->Arg(1);
+BENCHMARK(HuffmanDictionary_create_part_chunks)->Range(1<<16, 1<<22);
+BENCHMARK(FrequencyAccumulator_add_chunks)->Range(1<<16, 1<<22);
@@ -0,0 +1,100 @@
+#include <huffman/HuffmanDictionary.hpp>
+#include <huffman/StaticDictionary.hpp>
+#include <benchmark/benchmark.h>
+
+#include <string_view>
+#include <vector>
+
+using namespace huffman;
+
+namespace
+{
+
+// Short message of lowercase letters and spaces
+constexpr std::string_view message = "the quick brown fox jumps over the lazy dog and runs away from it";
+
+// The 5 most common symbols of the message take 4 bits, the other 22 take 5
+constexpr std::array<uint8_t, 256> message_lengths = []
+{
+	std::array<uint8_t, 256> lengths{};
+	for(char c : std::string_view("abcdefghijklmnopqrstuvwxyz "))
+	{
+		lengths[static_cast<unsigned char>(c)] = 5;
+	}
+
+	for(char c : std::string_view(" eoru"))
+	{
+		lengths[static_cast<unsigned char>(c)] = 4;
+	}
+
+	return lengths;
+}();
+
+void StaticDictionary_encode(benchmark::State& state)
+{
+	std::vector<char> output(message.size());
+
+	for(auto _ : state)
+	{
+		static_dictionary<message_lengths>.encode(message.data(), message.size(), output.data(), output.size());
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(message.size()));
+}
+
+void StaticDictionary_decode(benchmark::State& state)
+{
+	std::vector<char> encoded(message.size());
+	static_dictionary<message_lengths>.encode(message.data(), message.size(), encoded.data(), encoded.size());
+	std::vector<char> output(message.size());
+
+	for(auto _ : state)
+	{
+		static_dictionary<message_lengths>.decode(encoded.data(), encoded.size(), output.data(), output.size());
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(message.size()));
+}
+
+void HuffmanDictionary_encode_message(benchmark::State& state)
+{
+	HuffmanDictionary dictionary(message.data(), message.size());
+	std::vector<char> output(message.size());
+
+	for(auto _ : state)
+	{
+		dictionary.encode(message.data(), message.size(), output.data(), output.size(), 0);
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(message.size()));
+}
+
+void HuffmanDictionary_decode_message(benchmark::State& state)
+{
+	HuffmanDictionary dictionary(message.data(), message.size());
+	std::vector<char> encoded(message.size());
+	dictionary.encode(message.data(), message.size(), encoded.data(), encoded.size(), 0);
+	std::vector<char> output(message.size());
+
+	for(auto _ : state)
+	{
+		dictionary.decode(encoded.data(), encoded.size(), output.data(), output.size(), 0);
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(message.size()));
+}
+
+} // namespace
+
+BENCHMARK(StaticDictionary_encode);
+BENCHMARK(StaticDictionary_decode);
+BENCHMARK(HuffmanDictionary_encode_message);
+BENCHMARK(HuffmanDictionary_decode_message);
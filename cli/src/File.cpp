@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "File.hpp"
+
+namespace
+{
+
+// Read and write in chunks of this size when the file cannot be mapped
+constexpr size_t chunk_size = size_t{1} << 20;
+
+[[noreturn]] void throw_errno(const std::string& what)
+{
+	throw std::system_error(errno, std::generic_category(), what);
+}
+
+bool is_regular(int fd)
+{
+	struct stat status{};
+	return fstat(fd, &status) == 0 && S_ISREG(status.st_mode);
+}
+
+bool same_file(int fd, const std::string& path)
+{
+	struct stat status{};
+	struct stat path_status{};
+	return path != "-" && fstat(fd, &status) == 0 && stat(path.c_str(), &path_status) == 0
+		&& status.st_dev == path_status.st_dev && status.st_ino == path_status.st_ino;
+}
+
+} // namespace
+
+namespace cli
+{
+
+InputFile::InputFile(const std::string& path)
+	: m_fd{path == "-" ? STDIN_FILENO : open(path.c_str(), O_RDONLY)}, m_mapping{nullptr}, m_size{0}, m_buffer{}
+{
+	if(m_fd < 0)
+	{
+		throw_errno("cannot open " + path);
+	}
+
+	struct stat status{};
+	if(fstat(m_fd, &status) == 0 && S_ISREG(status.st_mode))
+	{
+		m_size = static_cast<size_t>(status.st_size);
+
+		// Empty files cannot be mapped
+		if(m_size != 0)
+		{
+			m_mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+			if(m_mapping == MAP_FAILED)
+			{
+				m_mapping = nullptr;
+				throw_errno("cannot map " + path);
+			}
+
+			madvise(m_mapping, m_size, MADV_SEQUENTIAL);
+		}
+
+		return;
+	}
+
+	while(true)
+	{
+		m_buffer.resize(m_size + chunk_size);
+		ssize_t count = read(m_fd, m_buffer.data() + m_size, chunk_size);
+		if(count < 0 && errno != EINTR)
+		{
+			throw_errno("cannot read " + path);
+		}
+
+		if(count == 0)
+		{
+			break;
+		}
+
+		m_size += count > 0 ? static_cast<size_t>(count) : 0;
+	}
+
+	m_buffer.resize(m_size);
+}
+
+InputFile::~InputFile()
+{
+	if(m_mapping != nullptr)
+	{
+		munmap(m_mapping, m_size);
+	}
+
+	if(m_fd > STDERR_FILENO)
+	{
+		close(m_fd);
+	}
+}
+
+const char* InputFile::data() const
+{
+	return m_mapping != nullptr ? static_cast<const char*>(m_mapping) : m_buffer.data();
+}
+
+size_t InputFile::size() const
+{
+	return m_size;
+}
+
+bool InputFile::same_file(const std::string& path) const
+{
+	return ::same_file(m_fd, path);
+}
+
+OutputFile::OutputFile(const std::string& path)
+	: m_path{path}, m_fd{path == "-" ? STDOUT_FILENO : open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666)},
+	  m_regular{false}, m_committed{false}, m_mapping{nullptr}, m_mapping_size{0}, m_buffer{}
+{
+	if(m_fd < 0)
+	{
+		throw_errno("cannot open " + path);
+	}
+
+	m_regular = path != "-" && is_regular(m_fd);
+}
+
+OutputFile::~OutputFile()
+{
+	unmap();
+
+	if(m_fd > STDERR_FILENO)
+	{
+		close(m_fd);
+	}
+
+	// Truncated when opened, so nothing else is lost
+	if(m_regular && !m_committed)
+	{
+		unlink(m_path.c_str());
+	}
+}
+
+char* OutputFile::reserve(size_t size)
+{
+	unmap();
+
+	if(!m_regular || size == 0)
+	{
+		m_buffer.resize(size);
+		return m_buffer.data();
+	}
+
+	// The file is sparse until written, so reserving more than needed is cheap
+	if(ftruncate(m_fd, static_cast<off_t>(size)) != 0)
+	{
+		throw_errno("cannot resize the output");
+	}
+
+	m_mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+	if(m_mapping == MAP_FAILED)
+	{
+		m_mapping = nullptr;
+		throw_errno("cannot map the output");
+	}
+
+	m_mapping_size = size;
+	return static_cast<char*>(m_mapping);
+}
+
+void OutputFile::commit(size_t size)
+{
+	if(m_mapping != nullptr)
+	{
+		unmap();
+		if(ftruncate(m_fd, static_cast<off_t>(size)) != 0)
+		{
+			throw_errno("cannot resize the output");
+		}
+
+		m_committed = true;
+		return;
+	}
+
+	for(size_t written = 0; written < size;)
+	{
+		ssize_t count = write(m_fd, m_buffer.data() + written, std::min(size - written, chunk_size));
+		if(count < 0 && errno != EINTR)
+		{
+			throw_errno("cannot write the output");
+		}
+
+		written += count > 0 ? static_cast<size_t>(count) : 0;
+	}
+
+	m_committed = true;
+}
+
+bool OutputFile::same_file(const std::string& path) const
+{
+	return ::same_file(m_fd, path);
+}
+
+void OutputFile::unmap()
+{
+	if(m_mapping != nullptr)
+	{
+		munmap(m_mapping, m_mapping_size);
+		m_mapping = nullptr;
+		m_mapping_size = 0;
+	}
+}
+
+} // namespace cli
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace cli
+{
+
+/**
+ * Whole content of an input file. Regular files are memory-mapped, anything else
+ * (pipes, terminals) is read into a buffer.
+ */
+class InputFile
+{
+public:
+	/**
+	 * @brief				open and map the file, "-" for the standard input
+	 * @throws				std::system_error if the file cannot be opened, mapped or read
+	 */
+	explicit InputFile(const std::string& path);
+
+	InputFile(const InputFile&) = delete;
+	InputFile& operator=(const InputFile&) = delete;
+
+	~InputFile();
+
+	const char* data() const;
+	size_t size() const;
+
+	/**
+	 * @brief				check if the path names this file, through any link or path
+	 * @returns				false for "-" and for paths that do not exist
+	 * @throws				nothing
+	 */
+	bool same_file(const std::string& path) const;
+
+private:
+	int m_fd;
+	void* m_mapping;
+	size_t m_size;
+	std::vector<char> m_buffer;
+};
+
+/**
+ * Output file. Regular files are written through a shared memory mapping, anything else
+ * through a buffer that is written at once by commit(). A regular file is removed again
+ * if commit() is never reached, so that a failure does not leave partial content behind.
+ */
+class [[gnu::abi_tag("cxx11")]] OutputFile
+{
+public:
+	/**
+	 * @brief				create or truncate the file, "-" for the standard output
+	 * @throws				std::system_error if the file cannot be opened
+	 */
+	explicit OutputFile(const std::string& path);
+
+	OutputFile(const OutputFile&) = delete;
+	OutputFile& operator=(const OutputFile&) = delete;
+
+	~OutputFile();
+
+	/**
+	 * @brief				get a destination of at least size bytes for the content of the file
+	 * @throws				std::system_error if the file cannot be resized or mapped
+	 * @throws				std::bad_alloc
+	 */
+	char* reserve(size_t size);
+
+	/**
+	 * @brief				store the first size bytes of the destination from reserve() as the content of the file
+	 * @throws				std::system_error if the file cannot be written
+	 */
+	void commit(size_t size);
+
+	/**
+	 * @brief				check if the path names this file, through any link or path
+	 * @returns				false for "-" and for paths that do not exist
+	 * @throws				nothing
+	 */
+	bool same_file(const std::string& path) const;
+
+private:
+	void unmap();
+
+	std::string m_path;
+	int m_fd;
+	bool m_regular;
+	bool m_committed;
+	void* m_mapping;
+	size_t m_mapping_size;
+	std::vector<char> m_buffer;
+};
+
+} // namespace cli
@@ -0,0 +1,261 @@
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+#include <getopt.h>
+
+#include <huffman/Container.hpp>
+#include <huffman/HuffmanDictionary.hpp>
+
+#include "File.hpp"
+
+using namespace huffman;
+
+namespace
+{
+
+constexpr const char* usage =
+	"Usage: huffman-compression -i INPUT -o OUTPUT -m c|d [options]\n"
+	"\n"
+	"  -i, --input FILE        file to compress or decompress (- for the standard input)\n"
+	"  -o, --output FILE       file to write (- for the standard output)\n"
+	"  -m, -t, --mode c|d      compress (c) or decompress (d)\n"
+	"  -d, -s, --dictionary FILE\n"
+	"                          keep the dictionary in a separate file instead of the output\n"
+	"      --threads N         number of threads, 0 for one per hardware thread (default)\n"
+	"      --block-size N      number of input bytes in every block when compressing (default 65536)\n"
+	"  -h, --help              show this message\n";
+
+/**
+ * Invalid command line, reported together with the usage
+ */
+class UsageError final : public std::runtime_error
+{
+public:
+	using std::runtime_error::runtime_error;
+};
+
+enum class Mode
+{
+	none,
+	compress,
+	decompress,
+};
+
+struct Options
+{
+	std::string input{};
+	std::string output{};
+	std::string dictionary{};
+	Mode mode{Mode::none};
+	size_t threads{0};
+	size_t block_size{HuffmanDictionary::default_block_size};
+	bool help{false};
+};
+
+size_t parse_size(const std::string& value, const char* name)
+{
+	size_t end = 0;
+	unsigned long long result = 0;
+	try
+	{
+		result = std::stoull(value, &end);
+	}
+	catch(const std::exception&)
+	{
+		end = 0;
+	}
+
+	if(value.empty() || end != value.size() || value[0] == '-')
+	{
+		throw UsageError(std::string("invalid ") + name + ": " + value);
+	}
+
+	return static_cast<size_t>(result);
+}
+
+void parse_options(int argc, char** argv, Options& options)
+{
+	enum LongOption : int
+	{
+		threads_option = 256,
+		block_size_option,
+	};
+
+	static const option long_options[] = {
+		{"input", required_argument, nullptr, 'i'},
+		{"output", required_argument, nullptr, 'o'},
+		{"dictionary", required_argument, nullptr, 'd'},
+		{"mode", required_argument, nullptr, 'm'},
+		{"threads", required_argument, nullptr, threads_option},
+		{"block-size", required_argument, nullptr, block_size_option},
+		{"help", no_argument, nullptr, 'h'},
+		{nullptr, 0, nullptr, 0},
+	};
+
+	int opt = 0;
+	while((opt = getopt_long(argc, argv, "i:o:d:s:m:t:h", long_options, nullptr)) != -1)
+	{
+		switch(opt)
+		{
+			case 'i':
+				options.input = optarg;
+				break;
+			case 'o':
+				options.output = optarg;
+				break;
+			case 'd':
+			case 's':
+				options.dictionary = optarg;
+				break;
+			case 'm':
+			case 't':
+				if(std::string(optarg) == "c")
+				{
+					options.mode = Mode::compress;
+				}
+				else if(std::string(optarg) == "d")
+				{
+					options.mode = Mode::decompress;
+				}
+				else
+				{
+					throw UsageError(std::string("invalid mode: ") + optarg);
+				}
+				break;
+			case threads_option:
+				options.threads = parse_size(optarg, "number of threads");
+				break;
+			case block_size_option:
+				options.block_size = parse_size(optarg, "block size");
+				break;
+			case 'h':
+				options.help = true;
+				break;
+			default:
+				throw UsageError("invalid arguments");
+		}
+	}
+
+	if(optind != argc)
+	{
+		throw UsageError(std::string("unexpected argument: ") + argv[optind]);
+	}
+
+	if(!options.help && (options.input.empty() || options.output.empty() || options.mode == Mode::none))
+	{
+		throw UsageError("input, output and mode are required");
+	}
+}
+
+/**
+ * @brief				refuse to open an output over a file that is still read, it would be truncated first
+ * @throws				std::runtime_error if path names the file
+ */
+template<typename File>
+void check_not_same(const File& file, const std::string& path, const char* what)
+{
+	if(file.same_file(path))
+	{
+		throw std::runtime_error(path + " is also the " + what);
+	}
+}
+
+void compress_file(const Options& options)
+{
+	cli::InputFile input(options.input);
+	check_not_same(input, options.output, "input");
+	if(!options.dictionary.empty())
+	{
+		check_not_same(input, options.dictionary, "input");
+	}
+
+	if(options.dictionary.empty())
+	{
+		// The block size is checked before the output is touched
+		size_t bound = compress_bound(input.size(), options.block_size);
+		cli::OutputFile output(options.output);
+		char* dst = output.reserve(bound);
+		output.commit(compress(input.data(), input.size(), dst, bound, options.block_size, options.threads));
+		return;
+	}
+
+	// Only canonical dictionaries can be stored
+	HuffmanDictionary dictionary;
+	dictionary.create(input.data(), input.size(), 0, options.threads);
+	dictionary.canonicalize();
+	size_t bound = dictionary.encode_blocks_bound(input.size(), options.block_size);
+
+	cli::OutputFile output(options.output);
+	check_not_same(output, options.dictionary, "output");
+	cli::OutputFile dictionary_file(options.dictionary);
+	char* serialized = dictionary_file.reserve(HuffmanDictionary::max_serialized_size);
+	dictionary_file.commit(dictionary.serialize(serialized, HuffmanDictionary::max_serialized_size));
+
+	char* dst = output.reserve(bound);
+	output.commit(dictionary.encode_blocks(input.data(), input.size(), dst, bound, options.block_size, options.threads));
+}
+
+void decompress_file(const Options& options)
+{
+	cli::InputFile input(options.input);
+	check_not_same(input, options.output, "input");
+
+	if(options.dictionary.empty())
+	{
+		// The whole header is checked before the output is touched
+		ContainerReader reader(input.data(), input.size());
+		cli::OutputFile output(options.output);
+		char* dst = output.reserve(reader.size());
+		output.commit(reader.decompress(dst, reader.size(), options.threads));
+		return;
+	}
+
+	cli::InputFile dictionary_file(options.dictionary);
+	check_not_same(dictionary_file, options.output, "dictionary");
+	HuffmanDictionary dictionary;
+	dictionary.deserialize(dictionary_file.data(), dictionary_file.size());
+
+	size_t size = HuffmanDictionary::decoded_blocks_size(input.data(), input.size());
+	cli::OutputFile output(options.output);
+	char* dst = output.reserve(size);
+	output.commit(dictionary.decode_blocks(input.data(), input.size(), dst, size, options.threads));
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+	Options options;
+	try
+	{
+		parse_options(argc, argv, options);
+		if(options.help)
+		{
+			std::fputs(usage, stdout);
+			return 0;
+		}
+
+		if(options.mode == Mode::compress)
+		{
+			compress_file(options);
+		}
+		else
+		{
+			decompress_file(options);
+		}
+	}
+	catch(const UsageError& e)
+	{
+		std::fprintf(stderr, "huffman-compression: %s\n\n%s", e.what(), usage);
+		return 2;
+	}
+	catch(const std::exception& e)
+	{
+		std::fprintf(stderr, "huffman-compression: %s\n", e.what());
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace huffman
+{
+
+namespace adaptive
+{
+class Model;
+} // namespace adaptive
+
+namespace decoder
+{
+class DecodeTable;
+} // namespace decoder
+
+/**
+ * Decodes the output of AdaptiveEncoder in chunks, rebuilding the codes at the same bytes as the encoder.
+ *
+ * Like in StreamDecoder, a code split between two chunks is kept inside the decoder (never more
+ * than 64 bits), so chunks can be cut at any byte.
+ */
+class AdaptiveDecoder
+{
+public:
+	/**
+	 * @brief						create a decoder that starts with 8-bit codes for every byte
+	 * @param[in]	rebuild_period	number of bytes between two rebuilds of the codes, the same as the encoder's
+	 * @throws						std::invalid_argument if rebuild_period is 0
+	 * @throws						std::bad_alloc
+	 */
+	explicit AdaptiveDecoder(size_t rebuild_period);
+
+	AdaptiveDecoder(AdaptiveDecoder&&) noexcept;
+	AdaptiveDecoder& operator=(AdaptiveDecoder&&) noexcept;
+
+	~AdaptiveDecoder();
+
+	/**
+	 * @brief						decode the source until it ends or the destination is full
+	 * @param[in]		src			source
+	 * @param[in]		src_size	source size
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size
+	 * @returns						number of bytes read from src (first) and number of bytes written to dst (second)
+	 * @throws						std::bad_alloc
+	 * @note						the padding at the end of a finished stream may look like more codes, so dst_size
+	 *								should not be more than the number of bytes still expected
+	 */
+	std::pair<size_t, size_t> decode(const char* src, size_t src_size, char* dst, size_t dst_size);
+
+	/**
+	 * @brief						get the number of bits read but not decoded yet
+	 * @throws						nothing
+	 */
+	size_t pending_bits() const;
+
+	/**
+	 * @brief						drop the pending bits (e.g. the padding of a finished stream) and go back to the
+	 *								initial codes, to start a new stream
+	 * @throws						std::bad_alloc
+	 */
+	void reset();
+
+private:
+	std::unique_ptr<adaptive::Model> m_model;
+	std::unique_ptr<const decoder::DecodeTable> m_table;
+	uint64_t m_buffer{0};
+	size_t m_buffered{0};
+};
+
+} // namespace huffman
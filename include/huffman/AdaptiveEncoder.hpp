@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace huffman
+{
+
+namespace adaptive
+{
+class Model;
+} // namespace adaptive
+
+/**
+ * Encodes data that arrives in chunks in a single pass, without a dictionary made beforehand.
+ *
+ * The codes come from the bytes encoded so far: they start the same for every byte and are
+ * rebuilt from a running histogram every rebuild_period bytes. AdaptiveDecoder makes the same
+ * changes while decoding, so only the encoded bits are sent. Like in StreamEncoder, the bits
+ * that do not fit in the output buffer are kept inside the encoder (never more than 64 bits).
+ */
+class AdaptiveEncoder
+{
+public:
+	/// Suggested number of bytes between two rebuilds of the codes
+	static constexpr size_t default_rebuild_period = 8 * 1024;
+
+	/**
+	 * @brief						create an encoder that starts with 8-bit codes for every byte
+	 * @param[in]	rebuild_period	number of bytes between two rebuilds of the codes (the decoder must use the same)
+	 * @throws						std::invalid_argument if rebuild_period is 0
+	 * @throws						std::bad_alloc
+	 */
+	explicit AdaptiveEncoder(size_t rebuild_period);
+
+	AdaptiveEncoder(AdaptiveEncoder&&) noexcept;
+	AdaptiveEncoder& operator=(AdaptiveEncoder&&) noexcept;
+
+	~AdaptiveEncoder();
+
+	/**
+	 * @brief						encode as much of the source as fits in the destination
+	 * @param[in]		src			source
+	 * @param[in]		src_size	source size
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size
+	 * @returns						number of bytes read from src (first) and number of bytes written to dst (second)
+	 * @throws						std::bad_alloc
+	 */
+	std::pair<size_t, size_t> encode(const char* src, size_t src_size, char* dst, size_t dst_size);
+
+	/**
+	 * @brief						write the pending whole bytes
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size
+	 * @returns						number of bytes written to dst
+	 * @throws						nothing
+	 * @note						bits that do not fill a byte stay pending, so the stream can go on
+	 */
+	size_t flush(char* dst, size_t dst_size);
+
+	/**
+	 * @brief						end the stream, writing all pending bits (the last byte is padded with 0 bits)
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size
+	 * @returns						number of bytes written to dst
+	 * @throws						std::bad_alloc
+	 * @note						the stream is finished once pending_bits() is 0, call again with more space until then.
+	 *								The encoder then goes back to its initial codes to start a new stream
+	 */
+	size_t finish(char* dst, size_t dst_size);
+
+	/**
+	 * @brief						get the number of encoded bits not written yet
+	 * @throws						nothing
+	 */
+	size_t pending_bits() const;
+
+private:
+	size_t write(char* dst, size_t dst_size, size_t min_bits);
+
+	std::unique_ptr<adaptive::Model> m_model;
+	std::array<std::pair<uint64_t, size_t>, 256> m_codes;
+	uint64_t m_buffer{0};
+	size_t m_buffered{0};
+};
+
+} // namespace huffman
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "huffman/HuffmanDictionary.hpp"
+
+namespace huffman
+{
+
+/// Biggest block size of compress(), so that every compressed block size fits in 32 bits
+inline constexpr size_t max_container_block_size = size_t{1} << 29;
+
+/**
+ * @brief						get the biggest size compress() can write
+ * @param[in]		src_size	source size
+ * @param[in]		block_size	number of source bytes in every block
+ * @throws						std::invalid_argument if block_size is 0 or bigger than max_container_block_size
+ */
+size_t compress_bound(size_t src_size, size_t block_size);
+
+/**
+ * @brief						compress the data into a self-describing container
+ * @param[in]		src			source
+ * @param[in]		src_size	source size
+ * @param[out]		dst			destination
+ * @param[in]		dst_size	destination size (compress_bound() is always enough)
+ * @param[in]		block_size	number of source bytes in every block (the last one may be shorter)
+ * @param[in]		threads		number of threads (including the calling one), 0 for one per hardware thread
+ * @returns						number of bytes written to dst, 0 if dst is too small
+ * @throws						std::invalid_argument if block_size is 0 or bigger than max_container_block_size
+ * @throws						std::system_error if a thread cannot be started
+ * @throws						std::bad_alloc
+ * @note						the container starts with a magic number, a version, the source size and the block size,
+ *								followed by the number of dictionaries and the serialized dictionaries, then the original
+ *								size, compressed size, CRC-32C, type and dictionary of every block (all little-endian),
+ *								then a CRC-32C of everything before it, then the blocks, each starting at a byte boundary
+ * @note						every block is stored as is, as a single repeated byte or huffman-encoded, whichever is
+ *								the smallest, so the container is never much bigger than the source. A huffman-encoded
+ *								block keeps the dictionary of the previous one, or gets its own when that is smaller
+ *								including the size of the new dictionary, so data whose content changes compresses well
+ */
+size_t compress(const char* src, size_t src_size, char* dst, size_t dst_size, size_t block_size, size_t threads);
+
+/**
+ * @brief						get the number of bytes decompress() writes
+ * @param[in]		src			output of compress()
+ * @param[in]		src_size	source size
+ * @throws						std::invalid_argument if src does not start with a valid container header
+ * @throws						std::bad_alloc
+ */
+size_t decompressed_size(const char* src, size_t src_size);
+
+/**
+ * @brief						decompress the output of compress()
+ * @param[in]		src			source
+ * @param[in]		src_size	source size
+ * @param[out]		dst			destination
+ * @param[in]		dst_size	destination size (decompressed_size() is enough)
+ * @param[in]		threads		number of threads (including the calling one), 0 for one per hardware thread
+ * @returns						number of bytes written to dst, 0 if dst is too small
+ * @throws						std::invalid_argument if src is truncated, not valid or a checksum does not match
+ * @throws						std::system_error if a thread cannot be started
+ * @throws						std::bad_alloc
+ */
+size_t decompress(const char* src, size_t src_size, char* dst, size_t dst_size, size_t threads);
+
+/**
+ * Parsed header of the output of compress(), for decompressing single blocks.
+ *
+ * The header and the block table are checked once, when the reader is created; the source
+ * must outlive the reader.
+ */
+class ContainerReader
+{
+public:
+	/**
+	 * @brief						parse the header and the block table of the container
+	 * @param[in]		src			output of compress()
+	 * @param[in]		src_size	source size
+	 * @throws						std::invalid_argument if src is truncated or its header is not valid
+	 * @throws						std::bad_alloc
+	 */
+	ContainerReader(const char* src, size_t src_size);
+
+	ContainerReader(ContainerReader&&) noexcept;
+	ContainerReader& operator=(ContainerReader&&) noexcept;
+
+	ContainerReader(const ContainerReader&) = delete;
+	ContainerReader& operator=(const ContainerReader&) = delete;
+
+	~ContainerReader();
+
+	/**
+	 * @brief						get the number of decompressed bytes
+	 * @throws						nothing
+	 */
+	size_t size() const;
+
+	/**
+	 * @brief						get the number of decompressed bytes in every block but the last one
+	 * @throws						nothing
+	 */
+	size_t block_size() const;
+
+	/**
+	 * @brief						get the number of blocks
+	 * @throws						nothing
+	 */
+	size_t block_count() const;
+
+	/**
+	 * @brief						get the number of decompressed bytes in the block
+	 * @throws						std::out_of_range if block is not smaller than block_count()
+	 */
+	size_t decompressed_block_size(size_t block) const;
+
+	/**
+	 * @brief						get the number of dictionaries of the container
+	 * @throws						nothing
+	 */
+	size_t dictionary_count() const;
+
+	/**
+	 * @brief						get one of the dictionaries used by the blocks
+	 * @throws						std::out_of_range if index is not smaller than dictionary_count()
+	 */
+	const HuffmanDictionary& dictionary(size_t index) const;
+
+	/**
+	 * @brief						decompress a single block, which starts at block * block_size() in the decompressed data
+	 * @param[in]		block		index of the block
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size (decompressed_block_size() is enough)
+	 * @returns						number of bytes written to dst, 0 if dst is too small
+	 * @throws						std::out_of_range if block is not smaller than block_count()
+	 * @throws						std::invalid_argument if the block is truncated or its checksum does not match
+	 */
+	size_t decompress_block(size_t block, char* dst, size_t dst_size) const;
+
+	/**
+	 * @brief						decompress all blocks
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size (size() is enough)
+	 * @param[in]		threads		number of threads (including the calling one), 0 for one per hardware thread
+	 * @returns						number of bytes written to dst, 0 if dst is too small
+	 * @throws						std::invalid_argument if a block is truncated or its checksum does not match
+	 * @throws						std::system_error if a thread cannot be started
+	 */
+	size_t decompress(char* dst, size_t dst_size, size_t threads) const;
+
+private:
+	// Parsed entry of the block table
+	struct Block;
+
+	std::vector<HuffmanDictionary> m_dictionaries;
+	std::vector<Block> m_blocks;
+	const char* m_data;
+	size_t m_size;
+	size_t m_block_size;
+};
+
+} // namespace huffman
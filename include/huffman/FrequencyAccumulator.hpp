@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "huffman/HuffmanDictionary.hpp"
+
+namespace huffman
+{
+
+/**
+ * Counts bytes of data that arrives in chunks and builds a dictionary only when asked.
+ *
+ * Unlike HuffmanDictionary::create_part(), adding a chunk does not rebuild the tree.
+ */
+class FrequencyAccumulator
+{
+public:
+	FrequencyAccumulator() = default;
+
+	/**
+	 * @brief				count the bytes of the data
+	 * @param[in]	data	pointer to data
+	 * @param[in]	size	size of data
+	 * @throws				nothing
+	 */
+	void add(const char* data, size_t size);
+
+	/**
+	 * @brief				add the counts of another accumulator (e.g. one filled on another thread)
+	 * @throws				nothing
+	 */
+	void add(const FrequencyAccumulator& other);
+
+	/**
+	 * @brief				forget all counted bytes
+	 * @throws				nothing
+	 */
+	void clear();
+
+	/**
+	 * @brief				get the number of occurrences of every byte
+	 * @throws				nothing
+	 */
+	[[gnu::const]] const std::array<size_t, 256>& frequencies() const;
+
+	/**
+	 * @brief				get the number of counted bytes
+	 * @throws				nothing
+	 */
+	size_t size() const;
+
+	/**
+	 * @brief				check if no bytes were counted ( same as size() == 0 )
+	 * @throws				nothing
+	 */
+	bool empty() const;
+
+	/**
+	 * @brief				build a dictionary of the counted bytes
+	 * @throws				std::bad_alloc
+	 * @note				same as HuffmanDictionary::create() on all the data at once
+	 */
+	HuffmanDictionary dictionary() const;
+
+	/**
+	 * @brief							build a dictionary of the counted bytes with codes of limited length
+	 * @param[in]	max_code_length		maximum code length (at most HuffmanDictionary::code_length_limit), 0 for the default huffman tree
+	 * @throws							std::invalid_argument if max_code_length is too big, or too small for the number of distinct bytes
+	 * @throws							std::bad_alloc
+	 */
+	HuffmanDictionary dictionary(size_t max_code_length) const;
+
+private:
+	std::array<size_t, 256> m_frequencies{};
+	size_t m_size{0};
+};
+
+} // namespace huffman
@@ -1,21 +1,63 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <memory>
+#include <memory_resource>
+#include <span>
 
 #include "huffman/HuffmanNode.hpp"
+#include "huffman/HuffmanTree.hpp"
 
 namespace huffman
 {
 
+namespace decoder
+{
+class DecodeTable;
+} // namespace decoder
+
 class HuffmanDictionary
 {
 public:
-	HuffmanDictionary() = default;
+	/// Codes are never longer than this
+	static constexpr size_t code_length_limit = 32;
+
+	/// serialize() never writes more than this
+	static constexpr size_t max_serialized_size = 2 + 256;
+
+	/// Suggested block size for encode_blocks()
+	static constexpr size_t default_block_size = 64 * 1024;
+
+	/// encode_interleaved() splits the data into this many streams
+	static constexpr size_t interleaved_stream_count = 4;
+
+	/// Source of one message of encode_batch() and decode_batch()
+	struct Message
+	{
+		const char* data;
+		size_t size;
+	};
+
+	HuffmanDictionary();
+
+	/**
+	 * @brief					create an empty dictionary whose rebuilds allocate from the given resource
+	 * @param[in]	resource	memory resource of the tables and of create() (for example a per-thread
+	 *							std::pmr::monotonic_buffer_resource), it must outlive the dictionary and all its copies
+	 * @throws					std::bad_alloc
+	 * @note					copies share the tables and the resource of the dictionary they are copied from
+	 * @note					create() on more than one thread also allocates the threads themselves
+	 */
+	explicit HuffmanDictionary(std::pmr::memory_resource* resource);
+
 	HuffmanDictionary(const HuffmanNode& root);
 	HuffmanDictionary(const char* data, size_t size);
+	HuffmanDictionary(const char* data, size_t size, size_t max_code_length);
 
-	HuffmanDictionary(HuffmanDictionary&&) noexcept = default;
-	HuffmanDictionary& operator=(HuffmanDictionary&&) noexcept = default;
+	// A moved-from dictionary is left empty, keeping its memory resource
+	HuffmanDictionary(HuffmanDictionary&& other) noexcept;
+	HuffmanDictionary& operator=(HuffmanDictionary&& other) noexcept;
 
 	HuffmanDictionary(const HuffmanDictionary&) noexcept = default;
 	HuffmanDictionary& operator=(const HuffmanDictionary&) noexcept = default;
@@ -30,6 +72,39 @@ public:
 	 */
 	void create(const char* data, size_t size);
 
+	/**
+	 * @brief							create a new dictionary with canonical codes of limited length
+	 * @param[in]	data				pointer to data
+	 * @param[in]	size				size of data
+	 * @param[in]	max_code_length		maximum code length (at most code_length_limit), 0 for the default huffman tree
+	 * @throws							std::invalid_argument if max_code_length is too big, or too small for the number of distinct bytes
+	 * @throws							std::bad_alloc
+	 * @note							the limit is kept by create_part()
+	 */
+	void create(const char* data, size_t size, size_t max_code_length);
+
+	/**
+	 * @brief							create a new dictionary, counting the bytes on several threads
+	 * @param[in]	data				pointer to data
+	 * @param[in]	size				size of data
+	 * @param[in]	max_code_length		maximum code length (at most code_length_limit), 0 for the default huffman tree
+	 * @param[in]	threads				number of threads (including the calling one), 0 for one per hardware thread
+	 * @throws							std::invalid_argument if max_code_length is too big, or too small for the number of distinct bytes
+	 * @throws							std::system_error if a thread cannot be started
+	 * @throws							std::bad_alloc
+	 * @note							the dictionary is the same as the one made by create(data, size, max_code_length)
+	 */
+	void create(const char* data, size_t size, size_t max_code_length, size_t threads);
+
+	/**
+	 * @brief							create a new dictionary from already counted bytes
+	 * @param[in]	frequencies			number of occurrences of every byte
+	 * @param[in]	max_code_length		maximum code length (at most code_length_limit), 0 for the default huffman tree
+	 * @throws							std::invalid_argument if max_code_length is too big, or too small for the number of distinct bytes
+	 * @throws							std::bad_alloc
+	 */
+	void create(const std::array<size_t, 256>& frequencies, size_t max_code_length);
+
 	/**
 	 * @brief				create a new dictionary from the given data (partially)
 	 * @param[in]	data	pointer to data
@@ -38,6 +113,44 @@ public:
 	 */
 	void create_part(const char* data, size_t size);
 
+	/**
+	 * @brief				reassign the codes canonically, keeping their lengths
+	 * @throws				std::bad_alloc
+	 * @note				data encoded before the call cannot be decoded after it
+	 */
+	void canonicalize();
+
+	/**
+	 * @brief						store the code lengths of the dictionary
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size (max_serialized_size is always enough)
+	 * @returns						number of bytes written to dst, 0 if dst is too small
+	 * @throws						std::logic_error if the codes are not canonical (see canonicalize())
+	 * @throws						std::bad_alloc
+	 */
+	size_t serialize(char* dst, size_t dst_size) const;
+
+	/**
+	 * @brief						create the dictionary from the output of serialize()
+	 * @param[in]		src			source
+	 * @param[in]		src_size	source size
+	 * @returns						number of bytes read from src
+	 * @throws						std::invalid_argument if src is truncated or does not hold a valid dictionary
+	 * @throws						std::bad_alloc
+	 * @note						frequencies are not stored, every byte gets the weight 2^(longest code - its code length)
+	 * @note						the code length limit kept for create_part() is not changed
+	 */
+	size_t deserialize(const char* src, size_t src_size);
+
+	/**
+	 * @brief						get the number of bytes deserialize() reads, without building the dictionary
+	 * @param[in]		src			output of serialize()
+	 * @param[in]		src_size	source size
+	 * @throws						std::invalid_argument if src is truncated or does not start with a known format
+	 * @note						the code lengths are not checked, deserialize() may still throw
+	 */
+	static size_t serialized_size(const char* src, size_t src_size);
+
 	/**
 	 * @brief				get sum of all frequencies in the dictionary
 	 * @returns 			0 if the tree is not initialized, otherwise sum of all frequencies in the tree
@@ -53,23 +166,37 @@ public:
 	bool empty() const;
 
 	/**
-	 * @brief				return a pointer to the root node
-	 * @returns				nullptr if the tree is not initialized, otherwise a pointer to the root node
-	 * @throws				nothing
+	 * @brief				return the root node of a linked copy of the tree
+	 * @returns				the root node, valid until the dictionary changes or is destroyed
+	 * @throws				std::bad_alloc
+	 * @note				the linked tree is built on the first call after the dictionary changes, and shared by its copies
 	 */
 	const HuffmanNode& data() const;
 
 	/**
-	 * @brief						create a new dictionary (if not already initialized) and encode the data according to it
+	 * @brief				return the tree
+	 * @throws				nothing
+	 */
+	[[gnu::const]] const HuffmanTree& tree() const;
+
+	/**
+	 * @brief				get the memory resource the dictionary allocates from
+	 * @throws				nothing
+	 */
+	std::pmr::memory_resource* resource() const;
+
+	/**
+	 * @brief						encode the data according to the dictionary
 	 * @param[in]		src			source
 	 * @param[in]		src_size	source size
 	 * @param[out]		dst			destination
-	 * @param[in]		dst_size	destination size
+	 * @param[in]		dst_size	destination size (encode_bound() is always enough when bits_set is 0)
 	 * @param[in]		bits_set	numer of bits used in byte
 	 * @returns						number of bytes read from src (first) and number of bits written to dst (the last byte may be partially written) (second)
 	 * @throws						std::bad_alloc
+	 * @note						the code table is built on the first call after the dictionary changes
 	 */
-	std::pair<size_t, size_t> encode(const char* src, size_t src_size, char* dst, size_t dst_size, size_t bits_set);
+	std::pair<size_t, size_t> encode(const char* src, size_t src_size, char* dst, size_t dst_size, size_t bits_set) const;
 
 	/**
 	 * @brief						decode given data using the dictionary
@@ -80,11 +207,238 @@ public:
 	 * @param[in]		bits_set	numer of bits used in byte
 	 * @returns						number of bits read from src (first) and number of bytes written to dst (second)
 	 * @throws						std::bad_alloc
+	 * @note						the decode table is built on the first call after the dictionary changes
+	 */
+	std::pair<size_t, size_t> decode(const char* src, size_t src_size, char* dst, size_t dst_size, size_t bits_set) const;
+
+	/**
+	 * @brief						encode the data according to the dictionary
+	 * @param[in]		src			source
+	 * @param[out]		dst			destination (encode_bound() bytes are always enough when bits_set is 0)
+	 * @param[in]		bits_set	numer of bits used in byte
+	 * @returns						number of bytes read from src (first) and number of bits written to dst (the last byte may be partially written) (second)
+	 * @throws						std::bad_alloc
+	 */
+	std::pair<size_t, size_t> encode(std::span<const std::byte> src, std::span<std::byte> dst, size_t bits_set) const;
+
+	/**
+	 * @brief						decode given data using the dictionary
+	 * @param[in]		src			source
+	 * @param[out]		dst			destination
+	 * @param[in]		bits_set	numer of bits used in byte
+	 * @returns						number of bits read from src (first) and number of bytes written to dst (second)
+	 * @throws						std::bad_alloc
+	 */
+	std::pair<size_t, size_t> decode(std::span<const std::byte> src, std::span<std::byte> dst, size_t bits_set) const;
+
+	/**
+	 * @brief						encode the data of a scatter-gather list (an iovec or the two parts of a ring buffer) without copying it
+	 * @param[in]		src			source buffers, encoded as if they were one
+	 * @param[out]		dst			destination buffers, filled one after another as if they were one
+	 * @returns						number of bytes read from all of src (first) and number of bits written to all of dst (the last byte may be partially written) (second)
+	 * @throws						std::bad_alloc
+	 * @note						a code may start in one destination buffer and end in the next one, so the output is the
+	 *								same as the one of encode() on the concatenated source, split at the sizes of the buffers
+	 */
+	std::pair<size_t, size_t> encode(std::span<const std::span<const std::byte>> src, std::span<const std::span<std::byte>> dst) const;
+
+	/**
+	 * @brief						decode the data of a scatter-gather list without copying it
+	 * @param[in]		src			source buffers, decoded as if they were one (a code may start in one and end in the next one)
+	 * @param[out]		dst			destination buffers, filled one after another as if they were one
+	 * @returns						number of bits read from all of src (first) and number of bytes written to all of dst (second)
+	 * @throws						std::bad_alloc
+	 */
+	std::pair<size_t, size_t> decode(std::span<const std::span<const std::byte>> src, std::span<const std::span<std::byte>> dst) const;
+
+	/**
+	 * @brief						get the number of bits encode() writes for the given bytes
+	 * @param[in]	frequencies		number of occurrences of every byte
+	 * @throws						std::bad_alloc
+	 * @note						bytes that are not in the dictionary take no bits, like in encode()
 	 */
-	std::pair<size_t, size_t> decode(const char* src, size_t src_size, char* dst, size_t dst_size, size_t bits_set);
+	size_t encoded_bits(const std::array<size_t, 256>& frequencies) const;
+
+	/**
+	 * @brief						get the number of bits encode() writes for the source
+	 * @param[in]		src			source
+	 * @param[in]		src_size	source size
+	 * @throws						std::bad_alloc
+	 * @note						bytes that are not in the dictionary take no bits, like in encode()
+	 */
+	size_t encoded_bits(const char* src, size_t src_size) const;
+
+	/**
+	 * @brief						get the biggest size encode() can write, whatever the source holds
+	 * @param[in]		src_size	source size
+	 * @returns						number of bytes for src_size bytes taking the longest code, starting at bit 0
+	 * @throws						nothing
+	 */
+	size_t encode_bound(size_t src_size) const;
+
+	/**
+	 * @brief						get the biggest size encode_blocks() can write
+	 * @param[in]		src_size	source size
+	 * @param[in]		block_size	number of source bytes in every block
+	 * @throws						std::invalid_argument if block_size is 0
+	 */
+	size_t encode_blocks_bound(size_t src_size, size_t block_size) const;
+
+	/**
+	 * @brief						encode the data in blocks that can be decoded independently of each other
+	 * @param[in]		src			source
+	 * @param[in]		src_size	source size
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size (encode_blocks_bound() is always enough)
+	 * @param[in]		block_size	number of source bytes in every block (the last one may be shorter)
+	 * @param[in]		threads		number of threads (including the calling one), 0 for one per hardware thread
+	 * @returns						number of bytes written to dst, 0 if dst is too small
+	 * @throws						std::invalid_argument if block_size is 0
+	 * @throws						std::system_error if a thread cannot be started
+	 * @throws						std::bad_alloc
+	 * @note						the output starts with the source size and the block size, followed by the end of every
+	 *								block counted from the end of the index (all 64-bit little-endian), then the blocks, each
+	 *								starting at a byte boundary
+	 */
+	size_t encode_blocks(const char* src, size_t src_size, char* dst, size_t dst_size, size_t block_size, size_t threads) const;
+
+	/**
+	 * @brief						get the number of bytes decode_blocks() writes
+	 * @param[in]		src			output of encode_blocks()
+	 * @param[in]		src_size	source size
+	 * @throws						std::invalid_argument if src does not start with a valid block index
+	 */
+	static size_t decoded_blocks_size(const char* src, size_t src_size);
+
+	/**
+	 * @brief						decode the output of encode_blocks()
+	 * @param[in]		src			source
+	 * @param[in]		src_size	source size
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size (decoded_blocks_size() is enough)
+	 * @param[in]		threads		number of threads (including the calling one), 0 for one per hardware thread
+	 * @returns						number of bytes written to dst, 0 if dst is too small
+	 * @throws						std::invalid_argument if src is truncated or its block index is not valid
+	 * @throws						std::system_error if a thread cannot be started
+	 * @throws						std::bad_alloc
+	 */
+	size_t decode_blocks(const char* src, size_t src_size, char* dst, size_t dst_size, size_t threads) const;
+
+	/**
+	 * @brief						get the biggest size encode_interleaved() can write
+	 * @param[in]		src_size	source size
+	 * @throws						nothing
+	 */
+	size_t encode_interleaved_bound(size_t src_size) const;
+
+	/**
+	 * @brief						encode the data into interleaved_stream_count streams that are decoded together
+	 * @param[in]		src			source
+	 * @param[in]		src_size	source size
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size (encode_interleaved_bound() is always enough)
+	 * @returns						number of bytes written to dst, 0 if dst is too small
+	 * @throws						std::bad_alloc
+	 * @note						the source is split into interleaved_stream_count parts of ceil(src_size / interleaved_stream_count)
+	 *								bytes (the last ones may be shorter), each encoded into its own stream. The output starts with
+	 *								the source size and the sizes of all streams but the last (all 64-bit little-endian), followed
+	 *								by the streams, each starting at a byte boundary
+	 */
+	size_t encode_interleaved(const char* src, size_t src_size, char* dst, size_t dst_size) const;
+
+	/**
+	 * @brief						get the number of bytes decode_interleaved() writes
+	 * @param[in]		src			output of encode_interleaved()
+	 * @param[in]		src_size	source size
+	 * @throws						std::invalid_argument if src does not start with a valid header
+	 */
+	static size_t decoded_interleaved_size(const char* src, size_t src_size);
+
+	/**
+	 * @brief						decode the output of encode_interleaved()
+	 * @param[in]		src			source
+	 * @param[in]		src_size	source size
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size (decoded_interleaved_size() is enough)
+	 * @returns						number of bytes written to dst, 0 if dst is too small
+	 * @throws						std::invalid_argument if src is truncated or its header is not valid
+	 * @throws						std::bad_alloc
+	 */
+	size_t decode_interleaved(const char* src, size_t src_size, char* dst, size_t dst_size) const;
+
+	/**
+	 * @brief						get the biggest size encode_batch() can write
+	 * @param[in]		messages	messages to encode
+	 * @param[in]		count		number of messages
+	 * @throws						nothing
+	 */
+	size_t encode_batch_bound(const Message* messages, size_t count) const;
+
+	/**
+	 * @brief						encode every message on its own, one after another
+	 * @param[in]		messages	messages to encode
+	 * @param[in]		count		number of messages
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size (encode_batch_bound() is always enough)
+	 * @param[out]		sizes		encoded size of every message (count elements)
+	 * @param[in]		threads		number of threads (including the calling one), 0 for one per hardware thread
+	 * @returns						number of bytes written to dst, 0 if dst is too small
+	 * @throws						std::system_error if a thread cannot be started
+	 * @throws						std::bad_alloc
+	 * @note						every message starts at a byte boundary, right after the end of the previous one,
+	 *								so message i starts at the sum of sizes[0] to sizes[i - 1]
+	 */
+	size_t encode_batch(const Message* messages, size_t count, char* dst, size_t dst_size, size_t* sizes, size_t threads) const;
+
+	/**
+	 * @brief						decode every message on its own, one after another
+	 * @param[in]		messages	encoded messages, for example the ones written by encode_batch()
+	 * @param[in]		count		number of messages
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size (the sum of all sizes is enough)
+	 * @param[in]		sizes		decoded size of every message (count elements)
+	 * @param[in]		threads		number of threads (including the calling one), 0 for one per hardware thread
+	 * @returns						number of bytes written to dst, 0 if dst is too small
+	 * @throws						std::invalid_argument if a message is truncated
+	 * @throws						std::system_error if a thread cannot be started
+	 * @throws						std::bad_alloc
+	 * @note						the messages are written one after another, so message i starts at the sum of
+	 *								sizes[0] to sizes[i - 1]
+	 */
+	size_t decode_batch(const Message* messages, size_t count, char* dst, size_t dst_size, const size_t* sizes, size_t threads) const;
 
 private:
-	HuffmanNode m_root{0, 0};
+	// Encode and decode tables of the tree
+	struct Tables;
+
+	/**
+	 * @brief				get the tables shared by all empty dictionaries
+	 * @throws				nothing
+	 */
+	static const std::shared_ptr<Tables>& empty_tables() noexcept;
+
+	/**
+	 * @brief				replace the tree, dropping the tables of the old one
+	 * @throws				std::bad_alloc
+	 */
+	void set_tree(const HuffmanTree& tree);
+
+	/**
+	 * @brief				get the code of every byte, built on first use (thread-safe)
+	 * @throws				std::length_error if a code does not fit in 64 bits
+	 */
+	const std::array<std::pair<uint64_t, size_t>, 256>& codes() const;
+
+	/**
+	 * @brief				get the decode table, built on first use (thread-safe)
+	 * @throws				std::bad_alloc
+	 */
+	const decoder::DecodeTable& decode_table() const;
+
+	HuffmanTree m_tree{};
+	size_t m_max_code_length{0};
+	std::pmr::memory_resource* m_resource{std::pmr::get_default_resource()};
+	std::shared_ptr<Tables> m_tables;
 };
 
 } // namespace huffman
@@ -15,7 +15,7 @@ public:
 	HuffmanNode& operator=(HuffmanNode&& other) noexcept = default;
 
 	HuffmanNode(const HuffmanNode& other);
-	HuffmanNode& operator=(const HuffmanNode& other) noexcept;
+	HuffmanNode& operator=(const HuffmanNode& other);
 
 	~HuffmanNode() = default;
 
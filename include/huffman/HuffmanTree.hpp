@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "huffman/HuffmanNode.hpp"
+
+namespace huffman
+{
+
+/**
+ * Huffman tree stored in a fixed-size array of nodes that refer to their children by index.
+ *
+ * Children are always stored before their parent and the root is the last node, so a tree
+ * is copied with a single memcpy and never allocates. The nodes walked while decoding take
+ * 4 bytes each (2 KB for a full tree), the frequencies are kept in a separate array.
+ */
+class HuffmanTree
+{
+public:
+	using index_type = uint16_t;
+
+	/// Enough for a tree of all 256 bytes
+	static constexpr size_t max_nodes = 511;
+
+	/**
+	 * @brief				create a tree of a single byte node (byte 0, frequency 0), same as HuffmanNode{0, 0}
+	 * @throws				nothing
+	 */
+	HuffmanTree() noexcept;
+
+	/**
+	 * @brief				copy a linked tree
+	 * @throws				std::length_error if the tree has more than max_nodes nodes
+	 */
+	HuffmanTree(const HuffmanNode& root);
+
+	/**
+	 * @brief				remove all nodes (to build a new tree with add_byte_node() and add_node())
+	 * @throws				nothing
+	 */
+	void clear() noexcept;
+
+	/**
+	 * @brief				append a byte node
+	 * @returns				index of the new node
+	 * @throws				std::length_error if the tree already has max_nodes nodes
+	 */
+	index_type add_byte_node(char byte, size_t frequency);
+
+	/**
+	 * @brief				append a node with the given children
+	 * @returns				index of the new node
+	 * @throws				std::length_error if the tree already has max_nodes nodes
+	 */
+	index_type add_node(index_type left, index_type right);
+
+	size_t node_count() const;
+	index_type root() const;
+
+	bool is_byte_node(index_type index) const;
+	size_t frequency(index_type index) const;
+	char byte(index_type index) const;
+	index_type left(index_type index) const;
+	index_type right(index_type index) const;
+
+	/**
+	 * @brief				make a linked copy of a subtree
+	 * @throws				std::bad_alloc
+	 */
+	HuffmanNode node(index_type index) const;
+
+private:
+	static constexpr index_type byte_node_marker = 0xffff;
+
+	struct Node
+	{
+		index_type left;	// byte_node_marker for byte nodes
+		index_type right;	// the byte for byte nodes
+	};
+
+	index_type append(Node node, size_t frequency);
+
+	std::array<Node, max_nodes> m_nodes;
+	std::array<size_t, max_nodes> m_frequencies;
+	index_type m_size;
+};
+
+} // namespace huffman
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "huffman/HuffmanDictionary.hpp"
+
+namespace huffman
+{
+
+/**
+ * Dictionary with canonical codes fixed by their lengths, whose encode and decode tables
+ * can be built at compile time.
+ *
+ * The codes are the same as the ones of a canonical HuffmanDictionary with the same code
+ * lengths, so data encoded by one can be decoded by the other. Use static_dictionary to get
+ * a dictionary that is a compile-time constant.
+ */
+class StaticDictionary
+{
+public:
+	/// Number of bits that decode() looks up at once, longer codes are decoded bit by bit
+	static constexpr size_t root_bits = 10;
+
+	/**
+	 * @brief						build the tables of the dictionary
+	 * @param[in]	code_lengths	code length of every byte, 0 for bytes not in the dictionary
+	 * @throws						std::invalid_argument if a length exceeds HuffmanDictionary::code_length_limit
+	 *								or the lengths do not form a complete prefix code of at least two codes
+	 * @note						building the tables at run time is too big to be inlined
+	 */
+	[[gnu::noinline]] constexpr explicit StaticDictionary(const std::array<uint8_t, 256>& code_lengths)
+		: m_lengths{code_lengths}
+	{
+		check_lengths();
+		assign_codes();
+	}
+
+	/**
+	 * @brief						get the code length of every byte
+	 * @throws						nothing
+	 */
+	constexpr const std::array<uint8_t, 256>& code_lengths() const
+	{
+		return m_lengths;
+	}
+
+	/**
+	 * @brief						get the number of bits the source takes once encoded
+	 * @throws						std::invalid_argument if a byte of the source is not in the dictionary
+	 */
+	constexpr size_t encoded_bits(const char* src, size_t src_size) const
+	{
+		size_t bits = 0;
+		for(size_t si = 0; si < src_size; si++)
+		{
+			bits += length_of(src[si]);
+		}
+
+		return bits;
+	}
+
+	/**
+	 * @brief						encode the source
+	 * @param[in]		src			source
+	 * @param[in]		src_size	source size
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size
+	 * @returns						number of bytes read from src (first) and number of bits written to dst (the last byte may be partially written) (second)
+	 * @throws						std::invalid_argument if a byte of the source is not in the dictionary
+	 */
+	constexpr std::pair<size_t, size_t> encode(const char* src, size_t src_size, char* dst, size_t dst_size) const
+	{
+		uint64_t buffer = 0;
+		size_t buffered = 0;
+		size_t bits_written = 0;
+		size_t si = 0;
+
+		for(; si < src_size; si++)
+		{
+			size_t length = length_of(src[si]);
+			if(bits_written + length > dst_size*8)
+			{
+				break;
+			}
+
+			buffer |= uint64_t{m_codes[static_cast<unsigned char>(src[si])]} << buffered;
+			buffered += length;
+			bits_written += length;
+
+			// Codes are at most 32 bits long, so the buffer never overflows
+			if(buffered >= 32)
+			{
+				store(dst, buffer, 4);
+				dst += 4;
+				buffer >>= 32;
+				buffered -= 32;
+			}
+		}
+
+		store(dst, buffer, (buffered + 7) / 8);
+
+		return {si, bits_written};
+	}
+
+	/**
+	 * @brief						decode the source until it ends or the destination is full
+	 * @param[in]		src			source
+	 * @param[in]		src_size	source size
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size
+	 * @returns						number of bits read from src (first) and number of bytes written to dst (second)
+	 * @throws						nothing
+	 * @note						the padding at the end of the source may look like more codes, so dst_size
+	 *								should not be more than the number of bytes encoded
+	 */
+	constexpr std::pair<size_t, size_t> decode(const char* src, size_t src_size, char* dst, size_t dst_size) const noexcept
+	{
+		uint64_t buffer = 0;
+		size_t buffered = 0;
+		size_t bits_read = 0;
+		size_t si = 0;
+		size_t di = 0;
+
+		for(; di < dst_size; di++)
+		{
+			while(buffered <= 56 && si < src_size)
+			{
+				buffer |= uint64_t{static_cast<unsigned char>(src[si++])} << buffered;
+				buffered += 8;
+			}
+
+			RootEntry entry = m_root[buffer & ((uint64_t{1} << root_bits) - 1)];
+			size_t length = entry.length;
+			uint8_t byte = entry.byte;
+			if(length == 0 && !decode_long(buffer, buffered, byte, length))
+			{
+				break;
+			}
+
+			if(length > buffered)
+			{
+				break;
+			}
+
+			dst[di] = static_cast<char>(byte);
+			buffer >>= length;
+			buffered -= length;
+			bits_read += length;
+		}
+
+		return {bits_read, di};
+	}
+
+private:
+	static constexpr size_t max_lengths = HuffmanDictionary::code_length_limit + 1;
+
+	struct RootEntry
+	{
+		uint8_t byte;
+		uint8_t length;	// 0 if the code is longer than root_bits
+	};
+
+	constexpr void check_lengths()
+	{
+		uint64_t kraft_sum = 0;
+		for(uint8_t length : m_lengths)
+		{
+			if(length > HuffmanDictionary::code_length_limit)
+			{
+				throw std::invalid_argument("code length exceeds the code length limit");
+			}
+
+			if(length > 0)
+			{
+				m_counts[length]++;
+				kraft_sum += uint64_t{1} << (HuffmanDictionary::code_length_limit - length);
+				m_max_length = std::max<size_t>(m_max_length, length);
+			}
+		}
+
+		if(kraft_sum != uint64_t{1} << HuffmanDictionary::code_length_limit || m_max_length == 0)
+		{
+			throw std::invalid_argument("code lengths do not form a complete prefix code");
+		}
+	}
+
+	[[gnu::noinline]] constexpr void assign_codes()
+	{
+		// Canonical codes: consecutive values in the order of (length, byte), shifted left whenever the length grows
+		uint32_t code = 0;
+		uint16_t offset = 0;
+		for(size_t length = 1; length <= m_max_length; length++)
+		{
+			m_first[length] = code;
+			m_offsets[length] = offset;
+			code = (code + m_counts[length]) << 1;
+			offset = static_cast<uint16_t>(offset + m_counts[length]);
+		}
+
+		std::array<uint32_t, max_lengths> next{m_first};
+		for(size_t byte = 0; byte < m_lengths.size(); byte++)
+		{
+			size_t length = m_lengths[byte];
+			if(length > 0)
+			{
+				uint32_t value = next[length]++;
+				m_bytes[m_offsets[length] + value - m_first[length]] = static_cast<uint8_t>(byte);
+
+				// The first bit of a code is stored in the least significant position
+				m_codes[byte] = reverse(value, length);
+				fill_root(static_cast<uint8_t>(byte), length);
+			}
+		}
+	}
+
+	/**
+	 * @brief						point every root entry that starts with the code of the byte to it
+	 */
+	constexpr void fill_root(uint8_t byte, size_t length)
+	{
+		if(length > root_bits)
+		{
+			return;
+		}
+
+		for(size_t suffix = 0; suffix < (size_t{1} << (root_bits - length)); suffix++)
+		{
+			m_root[m_codes[byte] | (suffix << length)] = {byte, static_cast<uint8_t>(length)};
+		}
+	}
+
+	static constexpr uint32_t reverse(uint32_t value, size_t length)
+	{
+		uint32_t result = 0;
+		for(size_t i = 0; i < length; i++)
+		{
+			result = (result << 1) | ((value >> i) & 1);
+		}
+
+		return result;
+	}
+
+	static constexpr void store(char* dst, uint64_t value, size_t count)
+	{
+		for(size_t i = 0; i < count; i++)
+		{
+			dst[i] = static_cast<char>(value >> (i*8));
+		}
+	}
+
+	constexpr size_t length_of(char byte) const
+	{
+		size_t length = m_lengths[static_cast<unsigned char>(byte)];
+		if(length == 0)
+		{
+			throw std::invalid_argument("byte is not in the dictionary");
+		}
+
+		return length;
+	}
+
+	/**
+	 * @brief						decode a code longer than root_bits one bit at a time
+	 * @returns						false if the buffer ends before the code is complete
+	 */
+	constexpr bool decode_long(uint64_t buffer, size_t buffered, uint8_t& byte, size_t& length) const noexcept
+	{
+		uint32_t code = 0;
+		for(length = 1; length <= m_max_length && length <= buffered; length++)
+		{
+			code = (code << 1) | static_cast<uint32_t>((buffer >> (length - 1)) & 1);
+			if(code - m_first[length] < m_counts[length])
+			{
+				byte = m_bytes[m_offsets[length] + code - m_first[length]];
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	std::array<uint8_t, 256> m_lengths;
+	std::array<uint32_t, 256> m_codes{};
+	std::array<uint8_t, 256> m_bytes{};
+	std::array<uint32_t, max_lengths> m_first{};
+	std::array<uint16_t, max_lengths> m_counts{};
+	std::array<uint16_t, max_lengths> m_offsets{};
+	std::array<RootEntry, size_t{1} << root_bits> m_root{};
+	size_t m_max_length{0};
+};
+
+/// Dictionary of the given code lengths, built at compile time
+template<std::array<uint8_t, 256> CodeLengths>
+inline constexpr StaticDictionary static_dictionary{CodeLengths};
+
+} // namespace huffman
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "huffman/HuffmanDictionary.hpp"
+
+namespace huffman
+{
+
+namespace decoder
+{
+class DecodeTable;
+} // namespace decoder
+
+/**
+ * Decodes data that arrives in chunks into output buffers of any size.
+ *
+ * A code split between two chunks is kept inside the decoder (never more than 64 bits),
+ * so chunks can be cut at any byte.
+ */
+class StreamDecoder
+{
+public:
+	/**
+	 * @brief					create a decoder that uses the codes of the dictionary
+	 * @throws					std::bad_alloc
+	 * @note					the dictionary is copied, later changes to it do not affect the decoder
+	 */
+	explicit StreamDecoder(const HuffmanDictionary& dictionary);
+
+	StreamDecoder(StreamDecoder&&) noexcept;
+	StreamDecoder& operator=(StreamDecoder&&) noexcept;
+
+	~StreamDecoder();
+
+	/**
+	 * @brief						decode the source until it ends or the destination is full
+	 * @param[in]		src			source
+	 * @param[in]		src_size	source size
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size
+	 * @returns						number of bytes read from src (first) and number of bytes written to dst (second)
+	 * @throws						nothing
+	 * @note						the padding at the end of a finished stream may look like more codes, so dst_size
+	 *								should not be more than the number of bytes still expected
+	 */
+	std::pair<size_t, size_t> decode(const char* src, size_t src_size, char* dst, size_t dst_size);
+
+	/**
+	 * @brief						get the number of bits read but not decoded yet
+	 * @throws						nothing
+	 */
+	size_t pending_bits() const;
+
+	/**
+	 * @brief						drop the pending bits (e.g. the padding of a finished stream) to start a new stream
+	 * @throws						nothing
+	 */
+	void reset();
+
+private:
+	std::unique_ptr<const decoder::DecodeTable> m_table;
+	uint64_t m_buffer{0};
+	size_t m_buffered{0};
+};
+
+} // namespace huffman
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "huffman/HuffmanDictionary.hpp"
+
+namespace huffman
+{
+
+/**
+ * Encodes data that arrives in chunks into output buffers of any size.
+ *
+ * Bits that do not fill a whole byte yet, and bytes that did not fit in the last output buffer,
+ * are kept inside the encoder (never more than 64 bits), so the caller does not track offsets
+ * and never has to keep the previous output buffer around.
+ */
+class StreamEncoder
+{
+public:
+	/**
+	 * @brief					create an encoder that uses the codes of the dictionary
+	 * @throws					nothing
+	 * @note					the dictionary is copied, later changes to it do not affect the encoder
+	 */
+	explicit StreamEncoder(const HuffmanDictionary& dictionary);
+
+	/**
+	 * @brief						encode as much of the source as fits in the destination
+	 * @param[in]		src			source
+	 * @param[in]		src_size	source size
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size
+	 * @returns						number of bytes read from src (first) and number of bytes written to dst (second)
+	 * @throws						nothing
+	 */
+	std::pair<size_t, size_t> encode(const char* src, size_t src_size, char* dst, size_t dst_size);
+
+	/**
+	 * @brief						write the pending whole bytes
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size
+	 * @returns						number of bytes written to dst
+	 * @throws						nothing
+	 * @note						bits that do not fill a byte stay pending, so the stream can go on
+	 */
+	size_t flush(char* dst, size_t dst_size);
+
+	/**
+	 * @brief						end the stream, writing all pending bits (the last byte is padded with 0 bits)
+	 * @param[out]		dst			destination
+	 * @param[in]		dst_size	destination size
+	 * @returns						number of bytes written to dst
+	 * @throws						nothing
+	 * @note						the stream is finished once pending_bits() is 0, call again with more space until then.
+	 *								The encoder can then start a new stream
+	 */
+	size_t finish(char* dst, size_t dst_size);
+
+	/**
+	 * @brief						get the number of encoded bits not written yet
+	 * @throws						nothing
+	 */
+	size_t pending_bits() const;
+
+private:
+	size_t write(char* dst, size_t dst_size, size_t min_bits);
+
+	std::array<std::pair<uint64_t, size_t>, 256> m_codes;
+	uint64_t m_buffer{0};
+	size_t m_buffered{0};
+};
+
+} // namespace huffman
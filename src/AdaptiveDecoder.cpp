@@ -0,0 +1,93 @@
+#include <huffman/AdaptiveDecoder.hpp>
+#include "adaptive/Model.hpp"
+#include "decoder/DecodeTable.hpp"
+
+namespace
+{
+
+uint64_t low_bits(uint64_t value, size_t count)
+{
+	return value & ((uint64_t{1} << count) - 1);
+}
+
+} // namespace
+
+namespace huffman
+{
+
+AdaptiveDecoder::AdaptiveDecoder(size_t rebuild_period)
+	: m_model{std::make_unique<adaptive::Model>(rebuild_period)},
+	  m_table{std::make_unique<const decoder::DecodeTable>(m_model->tree())}
+{
+
+}
+
+AdaptiveDecoder::AdaptiveDecoder(AdaptiveDecoder&&) noexcept = default;
+AdaptiveDecoder& AdaptiveDecoder::operator=(AdaptiveDecoder&&) noexcept = default;
+AdaptiveDecoder::~AdaptiveDecoder() = default;
+
+std::pair<size_t, size_t> AdaptiveDecoder::decode(const char* src, size_t src_size, char* dst, size_t dst_size)
+{
+	size_t bytes_read = 0;
+
+	for(size_t di = 0; di < dst_size; di++)
+	{
+		// Codes are at most 32 bits long, so they always fit after a refill
+		while(m_buffered <= 56 && bytes_read < src_size)
+		{
+			m_buffer |= uint64_t{static_cast<unsigned char>(src[bytes_read++])} << m_buffered;
+			m_buffered += 8;
+		}
+
+		const decoder::DecodeTable& table = *m_table;
+		size_t table_index = 0;
+		size_t table_bits = table.rootBits();
+		size_t code_bits = 0;
+
+		while(true)
+		{
+			const decoder::DecodeTable::Entry& entry = table[table_index + low_bits(m_buffer >> code_bits, table_bits)];
+
+			code_bits += entry.is_link ? table_bits : entry.length;
+			if(code_bits > m_buffered)
+			{
+				// The rest of the code comes in the next chunk
+				return {bytes_read, di};
+			}
+
+			if(!entry.is_link)
+			{
+				dst[di] = static_cast<char>(entry.value);
+				break;
+			}
+
+			table_index = entry.value;
+			table_bits = entry.length;
+		}
+
+		m_buffer = code_bits < 64 ? m_buffer >> code_bits : 0;
+		m_buffered -= code_bits;
+
+		if(m_model->update(dst[di]))
+		{
+			m_table = std::make_unique<const decoder::DecodeTable>(m_model->tree());
+		}
+	}
+
+	return {bytes_read, dst_size};
+}
+
+size_t AdaptiveDecoder::pending_bits() const
+{
+	return m_buffered;
+}
+
+void AdaptiveDecoder::reset()
+{
+	m_model->reset();
+	m_table = std::make_unique<const decoder::DecodeTable>(m_model->tree());
+	m_buffer = 0;
+	m_buffered = 0;
+}
+
+} // namespace huffman
@@ -0,0 +1,520 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include <huffman/Container.hpp>
+#include "canonical/CodeLengths.hpp"
+#include "checksum/Crc32c.hpp"
+#include "encoder/CodeTable.hpp"
+#include "encoder/Stream.hpp"
+#include "histogram/Histogram.hpp"
+#include "Endian.hpp"
+#include "Parallel.hpp"
+
+namespace
+{
+
+constexpr std::array<char, 4> magic{'H', 'U', 'F', 'C'};
+constexpr char container_version = 3;
+
+// Magic number, version, source size and block size
+constexpr size_t fixed_header_size = 4 + 1 + 8 + 4;
+
+// Number of dictionaries
+constexpr size_t dictionary_count_size = 4;
+
+// Original size, compressed size, checksum, type and dictionary of a block
+constexpr size_t block_entry_size = 4 + 4 + 4 + 1 + 4;
+
+// Checksum of the header and the block table
+constexpr size_t header_checksum_size = 4;
+
+/**
+ * How a block is stored
+ */
+enum class BlockType : uint8_t
+{
+	stored = 0,		// copied as is, when encoding would not make it smaller
+	rle = 1,		// a single byte repeated over the whole block
+	huffman = 2,	// encoded with one of the dictionaries of the container
+};
+
+void check_block_size(size_t block_size)
+{
+	if(block_size == 0 || block_size > huffman::max_container_block_size)
+	{
+		throw std::invalid_argument("block size is 0 or bigger than max_container_block_size");
+	}
+}
+
+size_t count_blocks(size_t src_size, size_t block_size)
+{
+	return src_size / block_size + (src_size % block_size != 0);
+}
+
+/**
+ * @brief					get the number of bytes the block takes once encoded with the code lengths
+ * @returns					the biggest size_t if a byte of the block has no code
+ */
+size_t huffman_size(const huffman::histogram::byte_frequencies& frequencies, const huffman::canonical::code_lengths& lengths)
+{
+	size_t bits = 0;
+	for(size_t i = 0; i < frequencies.size(); i++)
+	{
+		if(frequencies[i] != 0 && lengths[i] == 0)
+		{
+			return std::numeric_limits<size_t>::max();
+		}
+
+		bits += frequencies[i] * lengths[i];
+	}
+
+	return (bits + 7) / 8;
+}
+
+/**
+ * A dictionary made for a block, with everything needed to write it and to encode with it
+ */
+struct BlockDictionary
+{
+	std::array<char, huffman::HuffmanDictionary::max_serialized_size> serialized;
+	size_t serialized_size;
+	huffman::canonical::code_lengths lengths;
+	huffman::encoder::code_table codes;
+
+	explicit BlockDictionary(const huffman::histogram::byte_frequencies& frequencies)
+		: serialized{}, serialized_size{0}, lengths{}, codes{}
+	{
+		huffman::HuffmanDictionary dictionary;
+		dictionary.create(frequencies, 0);
+		dictionary.canonicalize();
+
+		serialized_size = dictionary.serialize(serialized.data(), serialized.size());
+		lengths = huffman::canonical::tree_code_lengths(dictionary.tree());
+		codes = huffman::encoder::make_code_table(dictionary.tree());
+	}
+};
+
+/**
+ * How every block is compressed, and the dictionaries made for them
+ */
+struct BlockPlan
+{
+	std::vector<BlockType> types;
+	std::vector<size_t> compressed_sizes;
+	std::vector<uint32_t> dictionary_indices;
+	std::vector<BlockDictionary> dictionaries;
+
+	/**
+	 * @brief					pick the smallest type of every block, in order, from their histograms
+	 * @note					a huffman block either keeps the last dictionary or gets a new one, which is only
+	 *							made when the block gets smaller by more than the size of the dictionary
+	 */
+	BlockPlan(const std::vector<huffman::histogram::byte_frequencies>& histograms, const std::vector<size_t>& sizes)
+		: types(sizes.size()), compressed_sizes(sizes.size()), dictionary_indices(sizes.size()), dictionaries{}
+	{
+		for(size_t block = 0; block < sizes.size(); block++)
+		{
+			const auto& frequencies = histograms[block];
+
+			if(std::count(frequencies.begin(), frequencies.end(), 0) == 255)
+			{
+				types[block] = BlockType::rle;
+				compressed_sizes[block] = 1;
+				continue;
+			}
+
+			// Stored blocks are the fastest to decompress, so they win ties, then kept dictionaries
+			types[block] = BlockType::stored;
+			compressed_sizes[block] = sizes[block];
+
+			if(!dictionaries.empty())
+			{
+				size_t kept_size = huffman_size(frequencies, dictionaries.back().lengths);
+				if(kept_size < compressed_sizes[block])
+				{
+					types[block] = BlockType::huffman;
+					compressed_sizes[block] = kept_size;
+					dictionary_indices[block] = static_cast<uint32_t>(dictionaries.size() - 1);
+				}
+			}
+
+			BlockDictionary dictionary(frequencies);
+			size_t new_size = huffman_size(frequencies, dictionary.lengths);
+			if(new_size + dictionary.serialized_size < compressed_sizes[block])
+			{
+				types[block] = BlockType::huffman;
+				compressed_sizes[block] = new_size;
+				dictionary_indices[block] = static_cast<uint32_t>(dictionaries.size());
+				dictionaries.push_back(dictionary);
+			}
+		}
+	}
+};
+
+struct FixedHeader
+{
+	size_t size;
+	size_t block_size;
+};
+
+/**
+ * @brief					check the fixed part of the header
+ */
+FixedHeader read_fixed_header(const char* src, size_t src_size)
+{
+	if(src_size < fixed_header_size)
+	{
+		throw std::invalid_argument("container header is truncated");
+	}
+
+	if(!std::equal(magic.begin(), magic.end(), src))
+	{
+		throw std::invalid_argument("not a huffman container");
+	}
+
+	if(src[4] != container_version)
+	{
+		throw std::invalid_argument("unsupported container version");
+	}
+
+	size_t size = huffman::load_le64(src + 5);
+	size_t block_size = huffman::load_le32(src + 13);
+	if(block_size == 0 || block_size > huffman::max_container_block_size)
+	{
+		throw std::invalid_argument("container block size is not valid");
+	}
+
+	return {size, block_size};
+}
+
+} // namespace
+
+namespace huffman
+{
+
+size_t compress_bound(size_t src_size, size_t block_size)
+{
+	check_block_size(block_size);
+
+	// Blocks that would grow are stored, and a dictionary is only added when its block gets smaller by more than its size
+	size_t blocks = count_blocks(src_size, block_size);
+	return fixed_header_size + dictionary_count_size + blocks*block_entry_size + header_checksum_size + src_size;
+}
+
+size_t compress(const char* src, size_t src_size, char* dst, size_t dst_size, size_t block_size, size_t threads)
+{
+	check_block_size(block_size);
+
+	size_t blocks = count_blocks(src_size, block_size);
+	std::vector<size_t> block_sizes(blocks);
+	for(size_t block = 0; block < blocks; block++)
+	{
+		block_sizes[block] = std::min(block_size, src_size - block*block_size);
+	}
+
+	// The histograms are the only pass over the data before it is encoded
+	std::vector<histogram::byte_frequencies> histograms(blocks);
+	std::vector<uint32_t> checksums(blocks);
+	parallel_for(blocks, threads, [&](size_t block)
+	{
+		const char* block_src = src + block*block_size;
+		histogram::count(histograms[block], block_src, block_sizes[block]);
+		checksums[block] = checksum::crc32c(0, block_src, block_sizes[block]);
+	});
+
+	// Types and sizes come from the histograms, so all blocks can be written at once
+	BlockPlan plan(histograms, block_sizes);
+
+	size_t header_size = fixed_header_size + dictionary_count_size + blocks*block_entry_size + header_checksum_size;
+	for(const BlockDictionary& dictionary : plan.dictionaries)
+	{
+		header_size += dictionary.serialized_size;
+	}
+
+	size_t size = header_size;
+	for(size_t compressed_size : plan.compressed_sizes)
+	{
+		size += compressed_size;
+	}
+
+	if(size > dst_size)
+	{
+		return 0;
+	}
+
+	std::copy(magic.begin(), magic.end(), dst);
+	dst[4] = container_version;
+	store_le64(dst + 5, src_size);
+	store_le32(dst + 13, static_cast<uint32_t>(block_size));
+	store_le32(dst + fixed_header_size, static_cast<uint32_t>(plan.dictionaries.size()));
+
+	char* entry = dst + fixed_header_size + dictionary_count_size;
+	for(const BlockDictionary& dictionary : plan.dictionaries)
+	{
+		std::memcpy(entry, dictionary.serialized.data(), dictionary.serialized_size);
+		entry += dictionary.serialized_size;
+	}
+
+	for(size_t block = 0; block < blocks; block++, entry += block_entry_size)
+	{
+		store_le32(entry, static_cast<uint32_t>(block_sizes[block]));
+		store_le32(entry + 4, static_cast<uint32_t>(plan.compressed_sizes[block]));
+		store_le32(entry + 8, checksums[block]);
+		entry[12] = static_cast<char>(plan.types[block]);
+		store_le32(entry + 13, plan.dictionary_indices[block]);
+	}
+
+	store_le32(entry, checksum::crc32c(0, dst, header_size - header_checksum_size));
+
+	// Turn the sizes into offsets of the blocks
+	std::vector<size_t> begins(blocks);
+	for(size_t block = 1; block < blocks; block++)
+	{
+		begins[block] = begins[block - 1] + plan.compressed_sizes[block - 1];
+	}
+
+	char* dst_blocks = dst + header_size;
+	parallel_for(blocks, threads, [&](size_t block)
+	{
+		const char* block_src = src + block*block_size;
+		char* block_dst = dst_blocks + begins[block];
+		if(plan.types[block] == BlockType::stored)
+		{
+			std::memcpy(block_dst, block_src, block_sizes[block]);
+		}
+		else if(plan.types[block] == BlockType::rle)
+		{
+			*block_dst = *block_src;
+		}
+		else
+		{
+			const encoder::code_table& codes = plan.dictionaries[plan.dictionary_indices[block]].codes;
+			encoder::encode_stream(codes, block_src, block_sizes[block], block_dst, plan.compressed_sizes[block]);
+		}
+	});
+
+	return size;
+}
+
+size_t decompressed_size(const char* src, size_t src_size)
+{
+	return read_fixed_header(src, src_size).size;
+}
+
+size_t decompress(const char* src, size_t src_size, char* dst, size_t dst_size, size_t threads)
+{
+	return ContainerReader(src, src_size).decompress(dst, dst_size, threads);
+}
+
+/**
+ * Entry of a block in the block table, with the offsets of the block counted from the first one
+ */
+struct ContainerReader::Block
+{
+	size_t begin;
+	size_t end;
+	uint32_t checksum;
+	BlockType type;
+	size_t dictionary;
+};
+
+ContainerReader::ContainerReader(const char* src, size_t src_size)
+	: m_dictionaries{}, m_blocks{}, m_data{nullptr}, m_size{0}, m_block_size{0}
+{
+	FixedHeader header = read_fixed_header(src, src_size);
+	m_size = header.size;
+	m_block_size = header.block_size;
+
+	size_t offset = fixed_header_size;
+	size_t blocks = count_blocks(m_size, m_block_size);
+	if(src_size - offset < dictionary_count_size)
+	{
+		throw std::invalid_argument("container header is truncated");
+	}
+
+	size_t dictionaries = load_le32(src + offset);
+	offset += dictionary_count_size;
+
+	// Every dictionary is used by a block and takes at least 2 bytes
+	if(dictionaries > blocks || dictionaries > (src_size - offset) / 2)
+	{
+		throw std::invalid_argument("container dictionary count is not valid");
+	}
+
+	// Only the sizes of the dictionaries are read until the checksum of the header matches
+	const char* serialized_dictionaries = src + offset;
+	for(size_t i = 0; i < dictionaries; i++)
+	{
+		offset += HuffmanDictionary::serialized_size(src + offset, src_size - offset);
+	}
+
+	if(blocks > (src_size - offset) / block_entry_size
+		|| src_size - offset - blocks*block_entry_size < header_checksum_size)
+	{
+		throw std::invalid_argument("container block table is truncated");
+	}
+
+	const char* block_table = src + offset;
+	offset += blocks*block_entry_size;
+	if(load_le32(src + offset) != checksum::crc32c(0, src, offset))
+	{
+		throw std::invalid_argument("container header checksum does not match");
+	}
+
+	offset += header_checksum_size;
+	m_data = src + offset;
+
+	m_dictionaries.resize(dictionaries);
+	for(HuffmanDictionary& dictionary : m_dictionaries)
+	{
+		serialized_dictionaries += dictionary.deserialize(serialized_dictionaries, static_cast<size_t>(block_table - serialized_dictionaries));
+	}
+
+	m_blocks.resize(blocks);
+	size_t data_size = src_size - offset;
+	size_t begin = 0;
+	for(size_t block = 0; block < blocks; block++)
+	{
+		const char* entry = block_table + block*block_entry_size;
+		size_t size = load_le32(entry);
+		if(size != std::min(m_block_size, m_size - block*m_block_size))
+		{
+			throw std::invalid_argument("container block size is not valid");
+		}
+
+		size_t compressed_size = load_le32(entry + 4);
+		if(compressed_size > data_size - begin)
+		{
+			throw std::invalid_argument("container block is truncated");
+		}
+
+		BlockType type = static_cast<BlockType>(entry[12]);
+		size_t dictionary = load_le32(entry + 13);
+		switch(type)
+		{
+		case BlockType::stored:
+			if(compressed_size != size)
+			{
+				throw std::invalid_argument("container stored block size is not valid");
+			}
+			break;
+		case BlockType::rle:
+			if(compressed_size != 1)
+			{
+				throw std::invalid_argument("container rle block size is not valid");
+			}
+			break;
+		case BlockType::huffman:
+			if(dictionary >= m_dictionaries.size())
+			{
+				throw std::invalid_argument("container block dictionary is not valid");
+			}
+			break;
+		default:
+			throw std::invalid_argument("unknown container block type");
+		}
+
+		m_blocks[block] = {begin, begin + compressed_size, load_le32(entry + 8), type, dictionary};
+		begin += compressed_size;
+	}
+}
+
+ContainerReader::ContainerReader(ContainerReader&&) noexcept = default;
+ContainerReader& ContainerReader::operator=(ContainerReader&&) noexcept = default;
+ContainerReader::~ContainerReader() = default;
+
+size_t ContainerReader::size() const
+{
+	return m_size;
+}
+
+size_t ContainerReader::block_size() const
+{
+	return m_block_size;
+}
+
+size_t ContainerReader::block_count() const
+{
+	return m_blocks.size();
+}
+
+size_t ContainerReader::decompressed_block_size(size_t block) const
+{
+	if(block >= block_count())
+	{
+		throw std::out_of_range("block index is out of range");
+	}
+
+	return std::min(m_block_size, m_size - block*m_block_size);
+}
+
+size_t ContainerReader::dictionary_count() const
+{
+	return m_dictionaries.size();
+}
+
+const HuffmanDictionary& ContainerReader::dictionary(size_t index) const
+{
+	if(index >= dictionary_count())
+	{
+		throw std::out_of_range("dictionary index is out of range");
+	}
+
+	return m_dictionaries[index];
+}
+
+size_t ContainerReader::decompress_block(size_t block, char* dst, size_t dst_size) const
+{
+	size_t size = decompressed_block_size(block);
+	if(size > dst_size)
+	{
+		return 0;
+	}
+
+	// Types, sizes and dictionaries were checked by the constructor
+	const Block& entry = m_blocks[block];
+	const char* block_src = m_data + entry.begin;
+	if(entry.type == BlockType::stored)
+	{
+		std::memcpy(dst, block_src, size);
+	}
+	else if(entry.type == BlockType::rle)
+	{
+		std::memset(dst, *block_src, size);
+	}
+	else
+	{
+		// The decode table of the dictionary is built by the first block that uses it
+		if(m_dictionaries[entry.dictionary].decode(block_src, entry.end - entry.begin, dst, size, 0).second != size)
+		{
+			throw std::invalid_argument("container block is truncated");
+		}
+	}
+
+	if(checksum::crc32c(0, dst, size) != entry.checksum)
+	{
+		throw std::invalid_argument("container block checksum does not match");
+	}
+
+	return size;
+}
+
+size_t ContainerReader::decompress(char* dst, size_t dst_size, size_t threads) const
+{
+	if(m_size > dst_size)
+	{
+		return 0;
+	}
+
+	parallel_for(block_count(), threads, [&](size_t block)
+	{
+		decompress_block(block, dst + block*m_block_size, m_size - block*m_block_size);
+	});
+
+	return m_size;
+}
+
+} // namespace huffman
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+namespace huffman
+{
+
+/**
+ * @brief				load 8 little-endian bytes (unaligned)
+ */
+inline uint64_t load_le64(const char* src)
+{
+	uint64_t value = 0;
+	if constexpr(std::endian::native == std::endian::little)
+	{
+		std::memcpy(&value, src, sizeof(value));
+	}
+	else
+	{
+		for(size_t i = 0; i < sizeof(value); i++)
+		{
+			value |= uint64_t{static_cast<unsigned char>(src[i])} << (i*8);
+		}
+	}
+
+	return value;
+}
+
+/**
+ * @brief				store 8 little-endian bytes (unaligned)
+ */
+inline void store_le64(char* dst, uint64_t value)
+{
+	if constexpr(std::endian::native == std::endian::little)
+	{
+		std::memcpy(dst, &value, sizeof(value));
+	}
+	else
+	{
+		for(size_t i = 0; i < sizeof(value); i++)
+		{
+			dst[i] = static_cast<char>(value >> (i*8));
+		}
+	}
+}
+
+/**
+ * @brief				load 4 little-endian bytes (unaligned)
+ */
+inline uint32_t load_le32(const char* src)
+{
+	uint32_t value = 0;
+	if constexpr(std::endian::native == std::endian::little)
+	{
+		std::memcpy(&value, src, sizeof(value));
+	}
+	else
+	{
+		for(size_t i = 0; i < sizeof(value); i++)
+		{
+			value |= uint32_t{static_cast<unsigned char>(src[i])} << (i*8);
+		}
+	}
+
+	return value;
+}
+
+/**
+ * @brief				store 4 little-endian bytes (unaligned)
+ */
+inline void store_le32(char* dst, uint32_t value)
+{
+	if constexpr(std::endian::native == std::endian::little)
+	{
+		std::memcpy(dst, &value, sizeof(value));
+	}
+	else
+	{
+		for(size_t i = 0; i < sizeof(value); i++)
+		{
+			dst[i] = static_cast<char>(value >> (i*8));
+		}
+	}
+}
+
+} // namespace huffman
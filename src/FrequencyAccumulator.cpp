@@ -0,0 +1,57 @@
+#include <huffman/FrequencyAccumulator.hpp>
+#include "histogram/Histogram.hpp"
+
+namespace huffman
+{
+
+void FrequencyAccumulator::add(const char* data, size_t size)
+{
+	histogram::count(m_frequencies, data, size);
+	m_size += size;
+}
+
+void FrequencyAccumulator::add(const FrequencyAccumulator& other)
+{
+	for(size_t i = 0; i < m_frequencies.size(); i++)
+	{
+		m_frequencies[i] += other.m_frequencies[i];
+	}
+
+	m_size += other.m_size;
+}
+
+void FrequencyAccumulator::clear()
+{
+	m_frequencies = {};
+	m_size = 0;
+}
+
+const std::array<size_t, 256>& FrequencyAccumulator::frequencies() const
+{
+	return m_frequencies;
+}
+
+size_t FrequencyAccumulator::size() const
+{
+	return m_size;
+}
+
+bool FrequencyAccumulator::empty() const
+{
+	return size() == 0;
+}
+
+HuffmanDictionary FrequencyAccumulator::dictionary() const
+{
+	return dictionary(0);
+}
+
+HuffmanDictionary FrequencyAccumulator::dictionary(size_t max_code_length) const
+{
+	HuffmanDictionary result;
+	result.create(m_frequencies, max_code_length);
+
+	return result;
+}
+
+} // namespace huffman
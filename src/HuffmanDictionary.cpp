@@ -1,73 +1,315 @@
+#include <algorithm>
 #include <array>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
 #include <vector>
 
 #include <huffman/HuffmanDictionary.hpp>
 #include <huffman/HuffmanNode.hpp>
-#include "decoder/ByteLoader.hpp"
-#include "decoder/ByteDecoder.hpp"
+#include <huffman/HuffmanTree.hpp>
+#include "canonical/CodeLengths.hpp"
+#include "decoder/BitReader.hpp"
+#include "decoder/DecodeTable.hpp"
+#include "decoder/InterleavedDecoder.hpp"
+#include "decoder/SegmentReader.hpp"
+#include "decoder/TableDecoder.hpp"
 #include "encoder/ByteWriter.hpp"
-#include "encoder/ByteEncoder.hpp"
+#include "encoder/CodeTable.hpp"
+#include "encoder/SegmentWriter.hpp"
+#include "encoder/Stream.hpp"
+#include "histogram/Histogram.hpp"
+#include "Endian.hpp"
+#include "Parallel.hpp"
+#include "Sort.hpp"
 
 namespace
 {
 
-using frequency_queue = std::vector<huffman::HuffmanNode>;
+using index_type = huffman::HuffmanTree::index_type;
 
-void get_frequencies(std::array<size_t, 256>& array, const char* src, size_t src_size)
+void get_frequencies(std::array<size_t, 256>& array, const huffman::HuffmanTree& tree)
 {
-	for(size_t i = 0; i < src_size; i++)
+	for(index_type i = 0; i < tree.node_count(); i++)
 	{
-		unsigned char index = static_cast<unsigned char>(src[i]);
+		if(tree.is_byte_node(i))
+		{
+			unsigned char index = static_cast<unsigned char>(tree.byte(i));
 
-		array[index]++;
+			array[index] += tree.frequency(i);
+		}
 	}
 }
 
-void get_frequencies(std::array<size_t, 256>& array, const huffman::HuffmanNode& node)
+/**
+ * Nodes merged while building the tree, in the order they are taken.
+ *
+ * Merged nodes are made in non-decreasing order of frequency and the newest of equally
+ * frequent nodes has always been taken first. All nodes of one frequency are made before
+ * the first of them is taken, so each run is reversed once, when its first node is taken.
+ */
+class MergedQueue
 {
-	if(node.is_byte_node())
+public:
+	bool empty() const
 	{
-		unsigned char index = static_cast<unsigned char>(node.byte());
+		return m_head == m_tail;
+	}
 
-		array[index] += node.frequency();
+	size_t frequency(const huffman::HuffmanTree& tree) const
+	{
+		return tree.frequency(m_nodes[m_head]);
 	}
-	else
+
+	index_type take(const huffman::HuffmanTree& tree)
+	{
+		if(m_head == m_ordered)
+		{
+			m_ordered = m_head + 1;
+			while(m_ordered < m_tail && tree.frequency(m_nodes[m_ordered]) == frequency(tree))
+			{
+				m_ordered++;
+			}
+
+			std::reverse(m_nodes.begin() + static_cast<std::ptrdiff_t>(m_head), m_nodes.begin() + static_cast<std::ptrdiff_t>(m_ordered));
+		}
+
+		return m_nodes[m_head++];
+	}
+
+	void push(index_type node)
+	{
+		m_nodes[m_tail++] = node;
+	}
+
+	size_t size() const
+	{
+		return m_tail - m_head;
+	}
+
+private:
+	std::array<index_type, 255> m_nodes{};
+	size_t m_head{0};
+	size_t m_tail{0};
+	size_t m_ordered{0};
+};
+
+/**
+ * Byte nodes not yet taken. They are the first nodes of the tree, added in the order they are taken.
+ */
+struct ByteQueue
+{
+	index_type head;
+	index_type tail;
+};
+
+index_type take_lightest(const huffman::HuffmanTree& tree, ByteQueue& bytes, MergedQueue& merged)
+{
+	// Merged nodes go before bytes of the same frequency
+	if(!merged.empty() && (bytes.head == bytes.tail || merged.frequency(tree) <= tree.frequency(bytes.head)))
+	{
+		return merged.take(tree);
+	}
+
+	return bytes.head++;
+}
+
+/**
+ * @returns		depth of the tree
+ */
+size_t make_huffman_tree(huffman::HuffmanTree& tree, ByteQueue bytes)
+{
+	if(bytes.head == bytes.tail)
+	{
+		tree = {};
+		return 0;
+	}
+
+	// Both queues stay sorted, so merging them replaces a priority queue
+	MergedQueue merged;
+	std::array<uint8_t, huffman::HuffmanTree::max_nodes> depths{};
+	while(static_cast<size_t>(bytes.tail - bytes.head) + merged.size() > 1)
+	{
+		index_type child_left = take_lightest(tree, bytes, merged);
+		index_type child_right = take_lightest(tree, bytes, merged);
+
+		index_type node = tree.add_node(child_left, child_right);
+		depths[node] = static_cast<uint8_t>(std::max(depths[child_left], depths[child_right]) + 1);
+		merged.push(node);
+	}
+
+	return depths[tree.root()];
+}
+
+huffman::HuffmanTree make_limited_tree(const std::array<size_t, 256>& byte_frequencies, size_t max_code_length, std::pmr::memory_resource* resource)
+{
+	auto lengths = huffman::canonical::limited_code_lengths(byte_frequencies, max_code_length, resource);
+	auto single_byte = std::find_if(byte_frequencies.begin(), byte_frequencies.end(), [](size_t freq){ return freq > 0; });
+
+	return huffman::canonical::make_canonical_tree(lengths, byte_frequencies,
+							static_cast<char>(single_byte == byte_frequencies.end() ? 0 : single_byte - byte_frequencies.begin()));
+}
+
+huffman::HuffmanTree make_tree(const std::array<size_t, 256>& byte_frequencies, size_t max_code_length, std::pmr::memory_resource* resource)
+{
+	if(max_code_length != 0)
+	{
+		return make_limited_tree(byte_frequencies, max_code_length, resource);
+	}
+
+	huffman::HuffmanTree tree;
+	tree.clear();
+
+	// Trim bytes that do not appear
+	std::array<unsigned char, 256> bytes{};
+	size_t byte_count = 0;
+	for(size_t i = 0; i < byte_frequencies.size(); i++)
 	{
-		get_frequencies(array, *node.left());
-		get_frequencies(array, *node.right());
+		if(byte_frequencies[i] > 0)
+		{
+			bytes[byte_count++] = static_cast<unsigned char>(i);
+		}
+	}
+
+	// Bigger bytes go first among equal frequencies
+	auto bytes_end = bytes.begin() + static_cast<std::ptrdiff_t>(byte_count);
+	huffman::small_stable_sort(bytes.begin(), bytes_end, [&](unsigned char a, unsigned char b)
+	{
+		return byte_frequencies[a] < byte_frequencies[b] || (byte_frequencies[a] == byte_frequencies[b] && a > b);
+	});
+
+	for(auto byte = bytes.begin(); byte != bytes_end; byte++)
+	{
+		tree.add_byte_node(static_cast<char>(*byte), byte_frequencies[*byte]);
+	}
+
+	size_t depth = make_huffman_tree(tree, {0, static_cast<index_type>(byte_count)});
+
+	// Very skewed frequencies make codes that are too long to be encoded
+	if(depth > huffman::HuffmanDictionary::code_length_limit)
+	{
+		return make_limited_tree(byte_frequencies, huffman::HuffmanDictionary::code_length_limit, resource);
 	}
+
+	return tree;
 }
 
-huffman::HuffmanNode makeTreeNode(frequency_queue& frequencies)
+enum class SerializedFormat : char
 {
-	huffman::HuffmanNode child_left = std::move(frequencies[0]);
-	huffman::HuffmanNode child_right = std::move(frequencies[1]);
+	empty,
+	single_byte,
+	nibble_lengths,
+	byte_lengths,
+};
 
-	frequencies.erase(frequencies.begin(), frequencies.begin()+2);
+constexpr char serialized_version = 1;
 
-	return {std::move(child_left), std::move(child_right)};
+// Source size and block size
+constexpr size_t blocks_header_size = 16;
+
+size_t block_count(size_t src_size, size_t block_size)
+{
+	return src_size / block_size + (src_size % block_size != 0);
 }
 
-huffman::HuffmanNode make_huffman_tree(frequency_queue& frequencies)
+/**
+ * Header and index of the output of encode_blocks()
+ */
+struct BlockIndex
 {
-	if(frequencies.size() == 0)
+	size_t decoded_size;
+	size_t block_size;
+	size_t count;
+	const char* ends;
+	const char* blocks;
+	size_t blocks_size;
+
+	BlockIndex(const char* src, size_t src_size)
+		: decoded_size{0}, block_size{0}, count{0}, ends{src + blocks_header_size}, blocks{nullptr}, blocks_size{0}
 	{
-		return {0, 0};
+		if(src_size < blocks_header_size)
+		{
+			throw std::invalid_argument("block index is truncated");
+		}
+
+		decoded_size = huffman::load_le64(src);
+		block_size = huffman::load_le64(src + 8);
+		if(block_size == 0)
+		{
+			throw std::invalid_argument("block size is 0");
+		}
+
+		count = block_count(decoded_size, block_size);
+		if(count > (src_size - blocks_header_size) / 8)
+		{
+			throw std::invalid_argument("block index is truncated");
+		}
+
+		blocks = ends + count*8;
+		blocks_size = src_size - blocks_header_size - count*8;
 	}
 
-	while(frequencies.size() > 1)
+	size_t begin(size_t block) const
 	{
-		auto new_node = makeTreeNode(frequencies);
+		return block == 0 ? 0 : end(block - 1);
+	}
 
-		auto node_position = std::find_if(frequencies.begin(),
-									frequencies.end(),
-									[&](const huffman::HuffmanNode& n)
-									{ return n.frequency() >= new_node.frequency(); });
+	size_t end(size_t block) const
+	{
+		return huffman::load_le64(ends + block*8);
+	}
+};
+
+constexpr size_t stream_count = huffman::HuffmanDictionary::interleaved_stream_count;
+
+// Source size and the sizes of all streams but the last
+constexpr size_t interleaved_header_size = 8 * stream_count;
+
+/**
+ * Parts of the source that go to every stream of encode_interleaved()
+ */
+struct InterleavedParts
+{
+	std::array<size_t, stream_count> begins;
+	std::array<size_t, stream_count> sizes;
 
-		frequencies.emplace(node_position, std::move(new_node));
+	explicit InterleavedParts(size_t src_size)
+		: begins{}, sizes{}
+	{
+		size_t part_size = src_size / stream_count + (src_size % stream_count != 0);
+		for(size_t i = 0; i < stream_count; i++)
+		{
+			begins[i] = std::min(part_size * i, src_size);
+			sizes[i] = std::min(part_size, src_size - begins[i]);
+		}
 	}
+};
 
-	return std::move(frequencies.front());
+// Messages of encode_batch() and decode_batch() are given to the threads in groups, so that short ones do not
+// wait on each other to take the next task
+constexpr size_t batch_group_size = 256;
+
+size_t batch_group_count(size_t count)
+{
+	return count / batch_group_size + (count % batch_group_size != 0);
+}
+
+/**
+ * @brief					call task(i) for every message of the batch, spread over threads
+ */
+template<typename Task>
+void batch_for(size_t count, size_t threads, const Task& task)
+{
+	huffman::parallel_for(batch_group_count(count), threads, [&](size_t group)
+	{
+		size_t end = std::min(count, (group + 1) * batch_group_size);
+		for(size_t i = group * batch_group_size; i < end; i++)
+		{
+			task(i);
+		}
+	});
 }
 
 } // namespace
@@ -75,25 +317,161 @@ huffman::HuffmanNode make_huffman_tree(frequency_queue& frequencies)
 namespace huffman
 {
 
+/**
+ * Tables of one tree, built on first use and shared by all copies of the dictionary
+ */
+struct HuffmanDictionary::Tables
+{
+	// Resource of the decode table, the one of the dictionary that made the tables
+	std::pmr::memory_resource* resource{std::pmr::get_default_resource()};
+	std::once_flag codes_built{};
+	std::once_flag decode_table_built{};
+	std::once_flag root_built{};
+	encoder::code_table codes{};
+	std::optional<decoder::DecodeTable> decode_table{};
+	std::optional<HuffmanNode> root{};
+};
+
+const std::shared_ptr<HuffmanDictionary::Tables>& HuffmanDictionary::empty_tables() noexcept
+{
+	// All empty dictionaries have the same tree, so they can share the tables
+	static const std::shared_ptr<Tables> tables = std::make_shared<Tables>();
+	return tables;
+}
+
+HuffmanDictionary::HuffmanDictionary()
+	: m_tables{empty_tables()}
+{
+
+}
+
+HuffmanDictionary::HuffmanDictionary(std::pmr::memory_resource* resource)
+	: HuffmanDictionary()
+{
+	m_resource = resource;
+}
+
 HuffmanDictionary::HuffmanDictionary(const char* src, size_t src_size)
+	: m_tables{}
 {
 	create(src, src_size);
 }
 
+HuffmanDictionary::HuffmanDictionary(const char* src, size_t src_size, size_t max_code_length)
+	: m_tables{}
+{
+	create(src, src_size, max_code_length);
+}
+
 HuffmanDictionary::HuffmanDictionary(const HuffmanNode& root)
+	: m_tree{root}, m_tables{}
+{
+	if(canonical::tree_depth(m_tree) > code_length_limit)
+	{
+		throw std::length_error("huffman tree is deeper than code_length_limit");
+	}
+
+	m_tables = std::allocate_shared<Tables>(std::pmr::polymorphic_allocator<Tables>{m_resource});
+	m_tables->resource = m_resource;
+}
+
+HuffmanDictionary::HuffmanDictionary(HuffmanDictionary&& other) noexcept
+	: m_tree{other.m_tree}, m_max_code_length{other.m_max_code_length}, m_resource{other.m_resource}, m_tables{std::move(other.m_tables)}
+{
+	other.m_tree = {};
+	other.m_tables = empty_tables();
+}
+
+HuffmanDictionary& HuffmanDictionary::operator=(HuffmanDictionary&& other) noexcept
 {
-	m_root = root;
+	if(this != &other)
+	{
+		m_tree = other.m_tree;
+		m_max_code_length = other.m_max_code_length;
+		m_resource = other.m_resource;
+		m_tables = std::move(other.m_tables);
+
+		other.m_tree = {};
+		other.m_tables = empty_tables();
+	}
+
+	return *this;
+}
+
+void HuffmanDictionary::set_tree(const HuffmanTree& tree)
+{
+	// Allocated first, so that the dictionary does not change if it throws
+	auto tables = std::allocate_shared<Tables>(std::pmr::polymorphic_allocator<Tables>{m_resource});
+	tables->resource = m_resource;
+
+	m_tree = tree;
+	m_tables = std::move(tables);
+}
+
+const encoder::code_table& HuffmanDictionary::codes() const
+{
+	std::call_once(m_tables->codes_built, [this]{ m_tables->codes = encoder::make_code_table(m_tree); });
+
+	return m_tables->codes;
+}
+
+const decoder::DecodeTable& HuffmanDictionary::decode_table() const
+{
+	std::call_once(m_tables->decode_table_built, [this]{ m_tables->decode_table.emplace(m_tree, m_tables->resource); });
+
+	return *m_tables->decode_table;
 }
 
 void HuffmanDictionary::create(const char* src, size_t src_size)
 {
-	m_root = {0, 0};
-	create_part(src, src_size);
+	create(src, src_size, 0);
+}
+
+void HuffmanDictionary::create(const char* src, size_t src_size, size_t max_code_length)
+{
+	create(src, src_size, max_code_length, 1);
+}
+
+void HuffmanDictionary::create(const char* src, size_t src_size, size_t max_code_length, size_t threads)
+{
+	if(max_code_length > code_length_limit)
+	{
+		// Checked before counting, which may take long
+		throw std::invalid_argument("max_code_length is bigger than code_length_limit");
+	}
+
+	std::array<size_t, 256> byte_frequencies{};
+	histogram::count_parallel(byte_frequencies, src, src_size, threads, m_resource);
+
+	create(byte_frequencies, max_code_length);
+}
+
+void HuffmanDictionary::create(const std::array<size_t, 256>& frequencies, size_t max_code_length)
+{
+	if(max_code_length > code_length_limit)
+	{
+		throw std::invalid_argument("max_code_length is bigger than code_length_limit");
+	}
+
+	set_tree(make_tree(frequencies, max_code_length, m_resource));
+	m_max_code_length = max_code_length;
 }
 
 const HuffmanNode& HuffmanDictionary::data() const
 {
-	return m_root;
+	std::call_once(m_tables->root_built, [this]{ m_tables->root.emplace(m_tree.node(m_tree.root())); });
+
+	return *m_tables->root;
+}
+
+const HuffmanTree& HuffmanDictionary::tree() const
+{
+	return m_tree;
+}
+
+std::pmr::memory_resource* HuffmanDictionary::resource() const
+{
+	return m_resource;
 }
 
 void HuffmanDictionary::create_part(const char* src, size_t src_size)
@@ -101,35 +479,158 @@ void HuffmanDictionary::create_part(const char* src, size_t src_size)
 	std::array<size_t, 256> byte_frequencies{};
 
 	// Get frequencies from the source
-	get_frequencies(byte_frequencies, src, src_size);
+	histogram::count(byte_frequencies, src, src_size);
 
 	// Get frequencies from the already existing tree
-	get_frequencies(byte_frequencies, m_root);
+	get_frequencies(byte_frequencies, m_tree);
 
-	// Convert the array to priority_queue
-	frequency_queue frequencies;
-	for(size_t i = 0; i < byte_frequencies.size(); i++)
+	// Make the new root
+	set_tree(make_tree(byte_frequencies, m_max_code_length, m_resource));
+}
+
+void HuffmanDictionary::canonicalize()
+{
+	std::array<size_t, 256> byte_frequencies{};
+	get_frequencies(byte_frequencies, m_tree);
+
+	set_tree(canonical::make_canonical_tree(canonical::tree_code_lengths(m_tree), byte_frequencies, m_tree.byte(m_tree.root())));
+}
+
+size_t HuffmanDictionary::serialize(char* dst, size_t dst_size) const
+{
+	if(!canonical::is_canonical(m_tree))
+	{
+		throw std::logic_error("only canonical dictionaries can be serialized");
+	}
+
+	auto lengths = canonical::tree_code_lengths(m_tree);
+	size_t longest = *std::max_element(lengths.begin(), lengths.end());
+
+	std::array<char, max_serialized_size> buffer{serialized_version};
+	size_t size = 2;
+
+	if(empty())
+	{
+		buffer[1] = static_cast<char>(SerializedFormat::empty);
+	}
+	else if(m_tree.is_byte_node(m_tree.root()))
+	{
+		buffer[1] = static_cast<char>(SerializedFormat::single_byte);
+		buffer[size++] = m_tree.byte(m_tree.root());
+	}
+	else if(longest < 16)
+	{
+		buffer[1] = static_cast<char>(SerializedFormat::nibble_lengths);
+		for(size_t i = 0; i < lengths.size(); i += 2)
+		{
+			buffer[size++] = static_cast<char>(lengths[i] | lengths[i+1] << 4);
+		}
+	}
+	else
+	{
+		buffer[1] = static_cast<char>(SerializedFormat::byte_lengths);
+		for(auto length : lengths)
+		{
+			buffer[size++] = static_cast<char>(length);
+		}
+	}
+
+	if(size > dst_size)
+	{
+		return 0;
+	}
+
+	std::copy_n(buffer.begin(), size, dst);
+	return size;
+}
+
+size_t HuffmanDictionary::serialized_size(const char* src, size_t src_size)
+{
+	if(src_size < 2 || src[0] != serialized_version)
+	{
+		throw std::invalid_argument("not a serialized dictionary");
+	}
+
+	size_t size = 2;
+	switch(static_cast<SerializedFormat>(src[1]))
+	{
+	case SerializedFormat::empty:
+		break;
+	case SerializedFormat::single_byte:
+		size += 1;
+		break;
+	case SerializedFormat::nibble_lengths:
+		size += 256 / 2;
+		break;
+	case SerializedFormat::byte_lengths:
+		size += 256;
+		break;
+	default:
+		throw std::invalid_argument("unknown dictionary format");
+	}
+
+	if(src_size < size)
+	{
+		throw std::invalid_argument("serialized dictionary is truncated");
+	}
+
+	return size;
+}
+
+size_t HuffmanDictionary::deserialize(const char* src, size_t src_size)
+{
+	size_t size = serialized_size(src, src_size);
+	canonical::code_lengths lengths{};
+	char single_byte = 0;
+
+	if(static_cast<SerializedFormat>(src[1]) == SerializedFormat::single_byte)
 	{
-		size_t freq = byte_frequencies[i];
-		// Trim bytes that do not appear
-		if(freq > 0)
+		single_byte = src[2];
+	}
+	else if(static_cast<SerializedFormat>(src[1]) == SerializedFormat::nibble_lengths)
+	{
+		for(size_t i = 0; i < lengths.size(); i += 2)
+		{
+			unsigned char packed = static_cast<unsigned char>(src[2 + i/2]);
+			lengths[i] = packed & 0xf;
+			lengths[i+1] = packed >> 4;
+		}
+	}
+	else if(static_cast<SerializedFormat>(src[1]) == SerializedFormat::byte_lengths)
+	{
+		for(size_t i = 0; i < lengths.size(); i++)
 		{
-			auto node_position = std::find_if(frequencies.begin(),
-									frequencies.end(),
-									[&](const huffman::HuffmanNode& n)
-									{ return n.frequency() >= freq; });
+			lengths[i] = static_cast<uint8_t>(src[2 + i]);
+		}
+	}
 
-			frequencies.emplace(node_position, static_cast<char>(i), freq);
+	size_t longest = *std::max_element(lengths.begin(), lengths.end());
+	std::array<size_t, 256> byte_frequencies{};
+	for(size_t i = 0; i < lengths.size(); i++)
+	{
+		if(lengths[i] > 0 && longest <= code_length_limit)
+		{
+			byte_frequencies[i] = size_t{1} << (longest - lengths[i]);
 		}
 	}
 
-	// Make the new root
-	m_root = make_huffman_tree(frequencies);
+	if(static_cast<SerializedFormat>(src[1]) == SerializedFormat::single_byte)
+	{
+		byte_frequencies[static_cast<unsigned char>(single_byte)] = 1;
+	}
+	else if(static_cast<SerializedFormat>(src[1]) != SerializedFormat::empty && longest == 0)
+	{
+		throw std::invalid_argument("serialized dictionary has no codes");
+	}
+
+	set_tree(canonical::make_canonical_tree(lengths, byte_frequencies, single_byte));
+
+	return size;
 }
 
 size_t HuffmanDictionary::size() const
 {
-	return m_root.frequency();
+	return m_tree.frequency(m_tree.root());
 }
 
 bool HuffmanDictionary::empty() const
@@ -137,42 +638,385 @@ bool HuffmanDictionary::empty() const
 	return size() == 0;
 }
 
-std::pair<size_t, size_t> HuffmanDictionary::encode(const char* src, size_t src_size, char* dst, size_t dst_size, size_t offset)
+std::pair<size_t, size_t> HuffmanDictionary::encode(const char* src, size_t src_size, char* dst, size_t dst_size, size_t offset) const
 {
+	const encoder::code_table& table = codes();
 	encoder::ByteWriter writer(dst, dst_size, offset);
-	encoder::ByteEncoder encoder(writer, m_root);
 	for(size_t si = 0; si < src_size; si++)
 	{
-		bool has_space = encoder.encode(src[si]);
+		auto[code, length] = table[static_cast<unsigned char>(src[si])];
+		bool has_space = writer.write(code, length);
 		if(!has_space)
 		{
+			writer.flush();
 			return {si, offset};
 		}
 
-		offset = encoder.bitsWritten();
+		offset = writer.bitsWritten();
 	}
 
+	writer.flush();
 	return {src_size, offset};
 }
 
-std::pair<size_t, size_t> HuffmanDictionary::decode(const char* src, size_t src_size, char* dst, size_t dst_size, size_t offset)
+std::pair<size_t, size_t> HuffmanDictionary::decode(const char* src, size_t src_size, char* dst, size_t dst_size, size_t offset) const
+{
+	decoder::BitReader reader(src, src_size, offset);
+	decoder::TableDecoder decoder(reader, decode_table());
+
+	size_t bytes_written = decoder.decode(dst, dst_size);
+
+	return {decoder.bitsProcessed(), bytes_written};
+}
+
+std::pair<size_t, size_t> HuffmanDictionary::encode(std::span<const std::byte> src, std::span<std::byte> dst, size_t bits_set) const
+{
+	return encode(reinterpret_cast<const char*>(src.data()), src.size(), reinterpret_cast<char*>(dst.data()), dst.size(), bits_set);
+}
+
+std::pair<size_t, size_t> HuffmanDictionary::decode(std::span<const std::byte> src, std::span<std::byte> dst, size_t bits_set) const
+{
+	return decode(reinterpret_cast<const char*>(src.data()), src.size(), reinterpret_cast<char*>(dst.data()), dst.size(), bits_set);
+}
+
+std::pair<size_t, size_t> HuffmanDictionary::encode(std::span<const std::span<const std::byte>> src, std::span<const std::span<std::byte>> dst) const
+{
+	const encoder::code_table& table = codes();
+	encoder::SegmentWriter writer(dst);
+	size_t bytes_read = 0;
+	for(std::span<const std::byte> segment : src)
+	{
+		for(std::byte byte : segment)
+		{
+			auto[code, length] = table[static_cast<unsigned char>(byte)];
+			bool has_space = writer.write(code, length);
+			if(!has_space)
+			{
+				writer.flush();
+				return {bytes_read, writer.bitsWritten()};
+			}
+
+			bytes_read++;
+		}
+	}
+
+	writer.flush();
+	return {bytes_read, writer.bitsWritten()};
+}
+
+std::pair<size_t, size_t> HuffmanDictionary::decode(std::span<const std::span<const std::byte>> src, std::span<const std::span<std::byte>> dst) const
 {
-	decoder::ByteLoader loader(src, src_size, offset);
-	decoder::ByteDecoder decoder(loader, m_root);
+	decoder::SegmentReader reader(src);
+	decoder::TableDecoder decoder(reader, decode_table());
 
-	for(size_t di = 0; di < dst_size; di++)
+	size_t bytes_written = 0;
+	for(std::span<std::byte> segment : dst)
 	{
-		auto[byte, is_set] = decoder.decode();
-		if(!is_set)
+		size_t written = decoder.decode(reinterpret_cast<char*>(segment.data()), segment.size());
+		bytes_written += written;
+		if(written < segment.size())
 		{
-			return {offset, di};
+			break;
 		}
+	}
+
+	return {decoder.bitsProcessed(), bytes_written};
+}
+
+size_t HuffmanDictionary::encoded_bits(const std::array<size_t, 256>& frequencies) const
+{
+	const encoder::code_table& table = codes();
+
+	size_t bits = 0;
+	for(size_t i = 0; i < frequencies.size(); i++)
+	{
+		bits += frequencies[i] * table[i].second;
+	}
+
+	return bits;
+}
 
-		dst[di] = byte;
-		offset = decoder.bitsProcessed();
+size_t HuffmanDictionary::encoded_bits(const char* src, size_t src_size) const
+{
+	histogram::byte_frequencies frequencies{};
+	histogram::count(frequencies, src, src_size);
+
+	return encoded_bits(frequencies);
+}
+
+size_t HuffmanDictionary::encode_bound(size_t src_size) const
+{
+	return (src_size*canonical::tree_depth(m_tree) + 7) / 8;
+}
+
+size_t HuffmanDictionary::encode_blocks_bound(size_t src_size, size_t block_size) const
+{
+	if(block_size == 0)
+	{
+		throw std::invalid_argument("block size is 0");
 	}
 
-	return {offset, dst_size};
+	size_t blocks = block_count(src_size, block_size);
+
+	// Every block may end with a partial byte
+	return blocks_header_size + blocks*8 + encode_bound(src_size) + blocks;
+}
+
+size_t HuffmanDictionary::encode_blocks(const char* src, size_t src_size, char* dst, size_t dst_size, size_t block_size, size_t threads) const
+{
+	if(block_size == 0)
+	{
+		throw std::invalid_argument("block size is 0");
+	}
+
+	size_t blocks = block_count(src_size, block_size);
+	auto lengths = canonical::tree_code_lengths(m_tree);
+	auto block_source_size = [&](size_t block){ return std::min(block_size, src_size - block*block_size); };
+
+	// The size of every block is known from its histogram, so all blocks can be written at once
+	std::vector<size_t> ends(blocks);
+	parallel_for(blocks, threads, [&](size_t block)
+	{
+		ends[block] = encoder::encoded_size(lengths, src + block*block_size, block_source_size(block));
+	});
+
+	for(size_t block = 1; block < blocks; block++)
+	{
+		ends[block] += ends[block - 1];
+	}
+
+	size_t index_size = blocks_header_size + blocks*8;
+	size_t size = index_size + (blocks == 0 ? 0 : ends.back());
+	if(size > dst_size)
+	{
+		return 0;
+	}
+
+	store_le64(dst, src_size);
+	store_le64(dst + 8, block_size);
+	for(size_t block = 0; block < blocks; block++)
+	{
+		store_le64(dst + blocks_header_size + block*8, ends[block]);
+	}
+
+	char* dst_blocks = dst + index_size;
+	parallel_for(blocks, threads, [&](size_t block)
+	{
+		size_t begin = block == 0 ? 0 : ends[block - 1];
+
+		encoder::encode_stream(codes(), src + block*block_size, block_source_size(block), dst_blocks + begin, ends[block] - begin);
+	});
+
+	return size;
+}
+
+size_t HuffmanDictionary::decoded_blocks_size(const char* src, size_t src_size)
+{
+	return BlockIndex(src, src_size).decoded_size;
+}
+
+size_t HuffmanDictionary::decode_blocks(const char* src, size_t src_size, char* dst, size_t dst_size, size_t threads) const
+{
+	BlockIndex index(src, src_size);
+	if(index.decoded_size > dst_size)
+	{
+		return 0;
+	}
+
+	for(size_t block = 0; block < index.count; block++)
+	{
+		if(index.end(block) < index.begin(block) || index.end(block) > index.blocks_size)
+		{
+			throw std::invalid_argument("block index is not valid");
+		}
+	}
+
+	const decoder::DecodeTable& table = decode_table();
+	parallel_for(index.count, threads, [&](size_t block)
+	{
+		size_t begin = index.begin(block);
+		size_t size = std::min(index.block_size, index.decoded_size - block*index.block_size);
+
+		decoder::BitReader reader(index.blocks + begin, index.end(block) - begin, 0);
+		decoder::TableDecoder decoder(reader, table);
+		if(decoder.decode(dst + block*index.block_size, size) != size)
+		{
+			throw std::invalid_argument("block is truncated");
+		}
+	});
+
+	return index.decoded_size;
+}
+
+size_t HuffmanDictionary::encode_interleaved_bound(size_t src_size) const
+{
+	// Every stream may end with a partial byte
+	return interleaved_header_size + encode_bound(src_size) + stream_count;
+}
+
+size_t HuffmanDictionary::encode_interleaved(const char* src, size_t src_size, char* dst, size_t dst_size) const
+{
+	InterleavedParts parts(src_size);
+	auto lengths = canonical::tree_code_lengths(m_tree);
+
+	std::array<size_t, stream_count> stream_sizes{};
+	size_t size = interleaved_header_size;
+	for(size_t i = 0; i < stream_count; i++)
+	{
+		stream_sizes[i] = encoder::encoded_size(lengths, src + parts.begins[i], parts.sizes[i]);
+		size += stream_sizes[i];
+	}
+
+	if(size > dst_size)
+	{
+		return 0;
+	}
+
+	store_le64(dst, src_size);
+	for(size_t i = 0; i + 1 < stream_count; i++)
+	{
+		store_le64(dst + 8 + i*8, stream_sizes[i]);
+	}
+
+	char* stream = dst + interleaved_header_size;
+	for(size_t i = 0; i < stream_count; i++)
+	{
+		encoder::encode_stream(codes(), src + parts.begins[i], parts.sizes[i], stream, stream_sizes[i]);
+		stream += stream_sizes[i];
+	}
+
+	return size;
+}
+
+size_t HuffmanDictionary::decoded_interleaved_size(const char* src, size_t src_size)
+{
+	if(src_size < interleaved_header_size)
+	{
+		throw std::invalid_argument("interleaved header is truncated");
+	}
+
+	return load_le64(src);
+}
+
+size_t HuffmanDictionary::decode_interleaved(const char* src, size_t src_size, char* dst, size_t dst_size) const
+{
+	size_t size = decoded_interleaved_size(src, src_size);
+	if(size > dst_size)
+	{
+		return 0;
+	}
+
+	// The last stream takes the rest of the source
+	std::array<size_t, stream_count> stream_sizes{};
+	size_t streams_left = src_size - interleaved_header_size;
+	for(size_t i = 0; i + 1 < stream_count; i++)
+	{
+		stream_sizes[i] = load_le64(src + 8 + i*8);
+		if(stream_sizes[i] > streams_left)
+		{
+			throw std::invalid_argument("interleaved stream is truncated");
+		}
+
+		streams_left -= stream_sizes[i];
+	}
+
+	stream_sizes.back() = streams_left;
+
+	InterleavedParts parts(size);
+	std::array<const char*, stream_count> streams{};
+	std::array<char*, stream_count> part_dst{};
+	for(size_t i = 0; i < stream_count; i++)
+	{
+		streams[i] = i == 0 ? src + interleaved_header_size : streams[i-1] + stream_sizes[i-1];
+		part_dst[i] = dst + parts.begins[i];
+	}
+
+	const decoder::DecodeTable& table = decode_table();
+	decoder::InterleavedDecoder decoder({
+		decoder::BitReader{streams[0], stream_sizes[0], 0},
+		decoder::BitReader{streams[1], stream_sizes[1], 0},
+		decoder::BitReader{streams[2], stream_sizes[2], 0},
+		decoder::BitReader{streams[3], stream_sizes[3], 0},
+	}, table);
+	if(!decoder.decode(part_dst, parts.sizes))
+	{
+		throw std::invalid_argument("interleaved stream is truncated");
+	}
+
+	return size;
+}
+
+size_t HuffmanDictionary::encode_batch_bound(const Message* messages, size_t count) const
+{
+	size_t longest = canonical::tree_depth(m_tree);
+
+	size_t size = 0;
+	for(size_t i = 0; i < count; i++)
+	{
+		size += (messages[i].size*longest + 7) / 8;
+	}
+
+	return size;
+}
+
+size_t HuffmanDictionary::encode_batch(const Message* messages, size_t count, char* dst, size_t dst_size, size_t* sizes, size_t threads) const
+{
+	const encoder::code_table& table = codes();
+
+	batch_for(count, threads, [&](size_t i)
+	{
+		sizes[i] = encoder::encoded_size(table, messages[i].data, messages[i].size);
+	});
+
+	// Begin of every message in dst
+	std::vector<size_t> begins(count);
+	size_t size = 0;
+	for(size_t i = 0; i < count; i++)
+	{
+		begins[i] = size;
+		size += sizes[i];
+	}
+
+	if(size > dst_size)
+	{
+		return 0;
+	}
+
+	batch_for(count, threads, [&](size_t i)
+	{
+		encoder::encode_stream(table, messages[i].data, messages[i].size, dst + begins[i], sizes[i]);
+	});
+
+	return size;
+}
+
+size_t HuffmanDictionary::decode_batch(const Message* messages, size_t count, char* dst, size_t dst_size, const size_t* sizes, size_t threads) const
+{
+	std::vector<size_t> begins(count);
+	size_t size = 0;
+	for(size_t i = 0; i < count; i++)
+	{
+		begins[i] = size;
+		size += sizes[i];
+	}
+
+	if(size > dst_size)
+	{
+		return 0;
+	}
+
+	const decoder::DecodeTable& table = decode_table();
+	batch_for(count, threads, [&](size_t i)
+	{
+		decoder::BitReader reader(messages[i].data, messages[i].size, 0);
+		decoder::TableDecoder decoder(reader, table);
+		if(decoder.decode(dst + begins[i], sizes[i]) != sizes[i])
+		{
+			throw std::invalid_argument("message is truncated");
+		}
+	});
+
+	return size;
 }
 
 } // namespace huffman
@@ -30,19 +30,12 @@ HuffmanNode::HuffmanNode(const HuffmanNode& other)
 	}
 }
 
-HuffmanNode& HuffmanNode::operator=(const HuffmanNode& other) noexcept
+HuffmanNode& HuffmanNode::operator=(const HuffmanNode& other)
 {
-	m_frequency = other.m_frequency;
-	m_is_byte_node = other.m_is_byte_node;
-	m_byte = other.m_byte;
+	// Copy first, so *this is left untouched if the copy throws
+	HuffmanNode copy{other};
 
-	if(!other.is_byte_node())
-	{
-		m_left = std::make_unique<HuffmanNode>(*other.m_left);
-		m_right = std::make_unique<HuffmanNode>(*other.m_right);
-	}
-
-	return *this;
+	return *this = std::move(copy);
 }
 
 bool HuffmanNode::is_byte_node() const
@@ -0,0 +1,111 @@
+#include <stdexcept>
+
+#include <huffman/HuffmanTree.hpp>
+
+namespace
+{
+
+huffman::HuffmanTree::index_type copy_node(huffman::HuffmanTree& tree, const huffman::HuffmanNode& node)
+{
+	if(node.is_byte_node())
+	{
+		return tree.add_byte_node(node.byte(), node.frequency());
+	}
+
+	auto left = copy_node(tree, *node.left());
+	auto right = copy_node(tree, *node.right());
+
+	return tree.add_node(left, right);
+}
+
+} // namespace
+
+namespace huffman
+{
+
+HuffmanTree::HuffmanTree() noexcept
+	: m_nodes{}, m_frequencies{}, m_size{1}
+{
+	m_nodes[0] = {byte_node_marker, 0};
+}
+
+HuffmanTree::HuffmanTree(const HuffmanNode& root)
+	: m_nodes{}, m_frequencies{}, m_size{0}
+{
+	copy_node(*this, root);
+}
+
+void HuffmanTree::clear() noexcept
+{
+	m_size = 0;
+}
+
+HuffmanTree::index_type HuffmanTree::add_byte_node(char byte, size_t frequency)
+{
+	return append({byte_node_marker, static_cast<unsigned char>(byte)}, frequency);
+}
+
+HuffmanTree::index_type HuffmanTree::add_node(index_type left, index_type right)
+{
+	return append({left, right}, m_frequencies[left] + m_frequencies[right]);
+}
+
+HuffmanTree::index_type HuffmanTree::append(Node node, size_t frequency)
+{
+	if(m_size == max_nodes)
+	{
+		throw std::length_error("huffman tree has too many nodes");
+	}
+
+	m_nodes[m_size] = node;
+	m_frequencies[m_size] = frequency;
+
+	return m_size++;
+}
+
+size_t HuffmanTree::node_count() const
+{
+	return m_size;
+}
+
+HuffmanTree::index_type HuffmanTree::root() const
+{
+	return static_cast<index_type>(m_size - 1);
+}
+
+bool HuffmanTree::is_byte_node(index_type index) const
+{
+	return m_nodes[index].left == byte_node_marker;
+}
+
+size_t HuffmanTree::frequency(index_type index) const
+{
+	return m_frequencies[index];
+}
+
+char HuffmanTree::byte(index_type index) const
+{
+	return is_byte_node(index) ? static_cast<char>(m_nodes[index].right) : '\0';
+}
+
+HuffmanTree::index_type HuffmanTree::left(index_type index) const
+{
+	return m_nodes[index].left;
+}
+
+HuffmanTree::index_type HuffmanTree::right(index_type index) const
+{
+	return m_nodes[index].right;
+}
+
+HuffmanNode HuffmanTree::node(index_type index) const
+{
+	if(is_byte_node(index))
+	{
+		return {byte(index), frequency(index)};
+	}
+
+	return {node(left(index)), node(right(index))};
+}
+
+} // namespace huffman
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace huffman
+{
+
+/**
+ * @brief					get the number of threads to use
+ * @param[in]	threads		requested number of threads, 0 for one per hardware thread
+ */
+inline size_t thread_count(size_t threads)
+{
+	if(threads == 0)
+	{
+		return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	}
+
+	return threads;
+}
+
+/**
+ * @brief					call task(i) for every i in [0, count), spread over threads (the calling thread included)
+ * @param[in]	count		number of tasks
+ * @param[in]	threads		number of threads, 0 for one per hardware thread
+ * @param[in]	task		function called with the index of the task
+ * @throws					the first exception thrown by a task, once all threads are done
+ * @throws					std::system_error if a thread cannot be started
+ */
+template<typename Task>
+void parallel_for(size_t count, size_t threads, const Task& task)
+{
+	threads = std::min(thread_count(threads), count);
+	if(threads <= 1)
+	{
+		for(size_t i = 0; i < count; i++)
+		{
+			task(i);
+		}
+
+		return;
+	}
+
+	// Tasks are taken one at a time, so threads that get cheaper tasks do more of them
+	std::atomic<size_t> next{0};
+	std::exception_ptr error;
+	std::mutex error_mutex;
+
+	auto work = [&]()
+	{
+		try
+		{
+			for(size_t i = next++; i < count; i = next++)
+			{
+				task(i);
+			}
+		}
+		catch(...)
+		{
+			std::lock_guard lock{error_mutex};
+			if(!error)
+			{
+				error = std::current_exception();
+			}
+
+			next = count;
+		}
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(threads - 1);
+	try
+	{
+		for(size_t i = 1; i < threads; i++)
+		{
+			workers.emplace_back(work);
+		}
+	}
+	catch(...)
+	{
+		next = count;
+		for(auto& worker : workers)
+		{
+			worker.join();
+		}
+
+		throw;
+	}
+
+	work();
+
+	for(auto& worker : workers)
+	{
+		worker.join();
+	}
+
+	if(error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
+} // namespace huffman
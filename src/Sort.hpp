@@ -0,0 +1,23 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+
+namespace huffman
+{
+
+/**
+ * @brief					sort a small range, keeping the order of equal elements, without allocating (unlike std::stable_sort)
+ * @param[in]	less		comparison of two elements
+ * @note					binary insertion sort, meant for ranges of at most 256 elements (one per byte)
+ */
+template<typename Iterator, typename Compare>
+void small_stable_sort(Iterator begin, Iterator end, const Compare& less)
+{
+	for(Iterator it = begin; it != end; ++it)
+	{
+		std::rotate(std::upper_bound(begin, it, *it, less), it, std::next(it));
+	}
+}
+
+} // namespace huffman
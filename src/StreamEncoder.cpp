@@ -0,0 +1,72 @@
+#include <huffman/StreamEncoder.hpp>
+#include "encoder/CodeTable.hpp"
+
+namespace huffman
+{
+
+StreamEncoder::StreamEncoder(const HuffmanDictionary& dictionary)
+	: m_codes{encoder::make_code_table(dictionary.tree())}
+{
+
+}
+
+std::pair<size_t, size_t> StreamEncoder::encode(const char* src, size_t src_size, char* dst, size_t dst_size)
+{
+	size_t bytes_written = 0;
+	for(size_t si = 0; si < src_size; si++)
+	{
+		auto[code, length] = m_codes[static_cast<unsigned char>(src[si])];
+		if(length == 0)
+		{
+			continue;
+		}
+
+		if(m_buffered + length > 64)
+		{
+			bytes_written += write(dst + bytes_written, dst_size - bytes_written, 8);
+
+			// Codes are at most 32 bits long, so after writing whole bytes a code always fits
+			if(m_buffered + length > 64)
+			{
+				return {si, bytes_written};
+			}
+		}
+
+		m_buffer |= code << m_buffered;
+		m_buffered += length;
+	}
+
+	bytes_written += write(dst + bytes_written, dst_size - bytes_written, 8);
+
+	return {src_size, bytes_written};
+}
+
+size_t StreamEncoder::flush(char* dst, size_t dst_size)
+{
+	return write(dst, dst_size, 8);
+}
+
+size_t StreamEncoder::finish(char* dst, size_t dst_size)
+{
+	return write(dst, dst_size, 1);
+}
+
+size_t StreamEncoder::pending_bits() const
+{
+	return m_buffered;
+}
+
+size_t StreamEncoder::write(char* dst, size_t dst_size, size_t min_bits)
+{
+	size_t bytes_written = 0;
+	while(m_buffered >= min_bits && bytes_written < dst_size)
+	{
+		dst[bytes_written++] = static_cast<char>(m_buffer);
+		m_buffer = m_buffered > 8 ? m_buffer >> 8 : 0;
+		m_buffered = m_buffered > 8 ? m_buffered - 8 : 0;
+	}
+
+	return bytes_written;
+}
+
+} // namespace huffman
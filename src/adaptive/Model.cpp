@@ -0,0 +1,49 @@
+#include <stdexcept>
+
+#include "Model.hpp"
+
+namespace huffman::adaptive
+{
+
+Model::Model(size_t period)
+	: m_frequencies{}, m_dictionary{}, m_total{0}, m_period{period}, m_left{period}
+{
+	if(period == 0)
+	{
+		throw std::invalid_argument("period is 0");
+	}
+
+	reset();
+}
+
+const HuffmanTree& Model::tree() const
+{
+	return m_dictionary.tree();
+}
+
+void Model::reset()
+{
+	m_frequencies.fill(1);
+	m_total = m_frequencies.size();
+	m_dictionary.create(m_frequencies, 0);
+	m_left = m_period;
+}
+
+void Model::halve()
+{
+	// Rounded up, so that every byte keeps a code
+	m_total = 0;
+	for(size_t& frequency : m_frequencies)
+	{
+		frequency = (frequency + 1) / 2;
+		m_total += frequency;
+	}
+}
+
+void Model::rebuild()
+{
+	m_dictionary.create(m_frequencies, 0);
+	m_left = m_period;
+}
+
+} // namespace huffman::adaptive
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+
+#include "huffman/HuffmanDictionary.hpp"
+#include "histogram/Histogram.hpp"
+
+namespace huffman::adaptive
+{
+
+/**
+ * Running histogram of the bytes seen so far, with a dictionary rebuilt from it every
+ * period bytes. The encoder and the decoder update their own model with the same bytes,
+ * so they always use the same codes.
+ *
+ * Every byte starts with a frequency of 1, so it can always be encoded, and all frequencies
+ * are halved whenever their sum reaches max_total, so old bytes matter less than new ones.
+ */
+class Model
+{
+public:
+	/// Sum of the frequencies that makes them halved
+	static constexpr size_t max_total = size_t{1} << 16;
+
+	/**
+	 * @throws				std::invalid_argument if period is 0
+	 * @throws				std::bad_alloc
+	 */
+	explicit Model(size_t period);
+
+	[[gnu::const]] const HuffmanTree& tree() const;
+
+	/**
+	 * @brief				count the byte, rebuilding the dictionary at the end of the period
+	 * @returns				true if the dictionary was rebuilt
+	 * @throws				std::bad_alloc
+	 */
+	bool update(char byte)
+	{
+		m_frequencies[static_cast<unsigned char>(byte)]++;
+		if(++m_total == max_total)
+		{
+			halve();
+		}
+
+		if(--m_left != 0)
+		{
+			return false;
+		}
+
+		rebuild();
+		return true;
+	}
+
+	/**
+	 * @brief				go back to the initial model
+	 * @throws				std::bad_alloc
+	 */
+	void reset();
+
+private:
+	void halve();
+	void rebuild();
+
+	histogram::byte_frequencies m_frequencies;
+	HuffmanDictionary m_dictionary;
+	size_t m_total;
+	size_t m_period;
+	size_t m_left;
+};
+
+} // namespace huffman::adaptive
@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <array>
+#include <memory_resource>
+#include <stdexcept>
+#include <vector>
+
+#include <huffman/HuffmanDictionary.hpp>
+#include "CodeLengths.hpp"
+#include "Sort.hpp"
+
+namespace
+{
+
+using huffman::canonical::code_lengths;
+
+// A leaf of the package-merge lists, or a package made of two items of the previous list
+struct Item
+{
+	size_t weight;
+	int symbol;
+	size_t first;
+};
+
+using item_list = std::pmr::vector<Item>;
+
+void count_lengths(const std::pmr::vector<item_list>& lists, size_t list, size_t index, code_lengths& lengths)
+{
+	const Item& item = lists[list][index];
+	if(item.symbol >= 0)
+	{
+		lengths[static_cast<size_t>(item.symbol)]++;
+	}
+	else
+	{
+		count_lengths(lists, list-1, item.first, lengths);
+		count_lengths(lists, list-1, item.first+1, lengths);
+	}
+}
+
+using index_type = huffman::HuffmanTree::index_type;
+
+void get_code_lengths(const huffman::HuffmanTree& tree, index_type index, code_lengths& lengths, uint8_t depth)
+{
+	if(tree.is_byte_node(index))
+	{
+		lengths[static_cast<unsigned char>(tree.byte(index))] = depth;
+	}
+	else
+	{
+		get_code_lengths(tree, tree.left(index), lengths, static_cast<uint8_t>(depth+1));
+		get_code_lengths(tree, tree.right(index), lengths, static_cast<uint8_t>(depth+1));
+	}
+}
+
+size_t get_depth(const huffman::HuffmanTree& tree, index_type index)
+{
+	if(tree.is_byte_node(index))
+	{
+		return 0;
+	}
+
+	return 1 + std::max(get_depth(tree, tree.left(index)), get_depth(tree, tree.right(index)));
+}
+
+struct Code
+{
+	uint64_t code;
+	uint8_t length;
+	char byte;
+};
+
+using code_iterator = const Code*;
+
+index_type make_node(huffman::HuffmanTree& tree, code_iterator begin, code_iterator end, size_t depth, const std::array<size_t, 256>& frequencies)
+{
+	if(begin->length == depth)
+	{
+		return tree.add_byte_node(begin->byte, frequencies[static_cast<unsigned char>(begin->byte)]);
+	}
+
+	// Codes are sorted, so the ones with 0 at this depth come first
+	auto left = std::find_if(begin, end, [&](const Code& c){ return (c.code >> (c.length - depth - 1)) & 1; });
+
+	auto left_index = make_node(tree, left, end, depth+1, frequencies);
+	auto right_index = make_node(tree, begin, left, depth+1, frequencies);
+
+	return tree.add_node(left_index, right_index);
+}
+
+bool same_codes(const huffman::HuffmanTree& lhs, index_type lhs_index, const huffman::HuffmanTree& rhs, index_type rhs_index)
+{
+	if(lhs.is_byte_node(lhs_index) || rhs.is_byte_node(rhs_index))
+	{
+		return lhs.is_byte_node(lhs_index) == rhs.is_byte_node(rhs_index) && lhs.byte(lhs_index) == rhs.byte(rhs_index);
+	}
+
+	return same_codes(lhs, lhs.left(lhs_index), rhs, rhs.left(rhs_index))
+		&& same_codes(lhs, lhs.right(lhs_index), rhs, rhs.right(rhs_index));
+}
+
+} // namespace
+
+namespace huffman::canonical
+{
+
+size_t tree_depth(const HuffmanTree& tree)
+{
+	return get_depth(tree, tree.root());
+}
+
+code_lengths tree_code_lengths(const HuffmanTree& tree)
+{
+	code_lengths lengths{};
+	get_code_lengths(tree, tree.root(), lengths, 0);
+
+	return lengths;
+}
+
+code_lengths limited_code_lengths(const std::array<size_t, 256>& frequencies, size_t max_length)
+{
+	return limited_code_lengths(frequencies, max_length, std::pmr::get_default_resource());
+}
+
+code_lengths limited_code_lengths(const std::array<size_t, 256>& frequencies, size_t max_length, std::pmr::memory_resource* resource)
+{
+	item_list leaves(resource);
+	for(size_t i = 0; i < frequencies.size(); i++)
+	{
+		if(frequencies[i] > 0)
+		{
+			leaves.push_back({frequencies[i], static_cast<int>(i), 0});
+		}
+	}
+
+	code_lengths lengths{};
+	if(leaves.size() < 2)
+	{
+		return lengths;
+	}
+
+	if(max_length < 64 && leaves.size() > (size_t{1} << max_length))
+	{
+		throw std::invalid_argument("max_length is too small for the number of bytes");
+	}
+
+	huffman::small_stable_sort(leaves.begin(), leaves.end(), [](const Item& lhs, const Item& rhs){ return lhs.weight < rhs.weight; });
+
+	// lists[0] holds the leaves at the deepest level, every next list merges the leaves with
+	// packages of pairs from the previous one
+	std::pmr::vector<item_list> lists(resource);
+	lists.reserve(std::max<size_t>(max_length, 1));
+	lists.push_back(leaves);
+	for(size_t level = 1; level < max_length; level++)
+	{
+		const item_list& previous = lists.back();
+		item_list current(resource);
+		current.reserve(leaves.size() + previous.size()/2);
+
+		auto leaf = leaves.begin();
+		for(size_t i = 0; i + 1 < previous.size(); i += 2)
+		{
+			size_t weight = previous[i].weight + previous[i+1].weight;
+			for(; leaf != leaves.end() && leaf->weight <= weight; leaf++)
+			{
+				current.push_back(*leaf);
+			}
+
+			current.push_back({weight, -1, i});
+		}
+		current.insert(current.end(), leaf, leaves.end());
+
+		lists.push_back(std::move(current));
+	}
+
+	// The 2n-2 lightest items of the last list select the code lengths
+	for(size_t i = 0; i < 2*leaves.size() - 2; i++)
+	{
+		count_lengths(lists, lists.size()-1, i, lengths);
+	}
+
+	return lengths;
+}
+
+bool is_canonical(const HuffmanTree& tree)
+{
+	if(tree.is_byte_node(tree.root()))
+	{
+		return true;
+	}
+
+	HuffmanTree canonical_tree = make_canonical_tree(tree_code_lengths(tree), {}, 0);
+
+	return same_codes(tree, tree.root(), canonical_tree, canonical_tree.root());
+}
+
+HuffmanTree make_canonical_tree(const code_lengths& lengths, const std::array<size_t, 256>& frequencies, char single_byte)
+{
+	// At most 256 codes, so building a tree allocates nothing
+	std::array<Code, 256> codes{};
+	size_t code_count = 0;
+	uint64_t kraft_sum = 0;
+	for(size_t i = 0; i < lengths.size(); i++)
+	{
+		if(lengths[i] > HuffmanDictionary::code_length_limit)
+		{
+			throw std::invalid_argument("code length exceeds the code length limit");
+		}
+
+		if(lengths[i] > 0)
+		{
+			codes[code_count++] = {0, lengths[i], static_cast<char>(i)};
+			kraft_sum += uint64_t{1} << (HuffmanDictionary::code_length_limit - lengths[i]);
+		}
+	}
+
+	if(code_count > 0 && kraft_sum != uint64_t{1} << HuffmanDictionary::code_length_limit)
+	{
+		throw std::invalid_argument("code lengths do not form a complete prefix code");
+	}
+
+	HuffmanTree tree;
+	tree.clear();
+
+	if(code_count == 0)
+	{
+		tree.add_byte_node(single_byte, frequencies[static_cast<unsigned char>(single_byte)]);
+		return tree;
+	}
+
+	huffman::small_stable_sort(codes.data(), codes.data() + code_count, [](const Code& lhs, const Code& rhs){ return lhs.length < rhs.length; });
+
+	// Canonical codes: consecutive values, shifted left whenever the length grows
+	uint64_t code = 0;
+	for(size_t i = 0; i < code_count; i++)
+	{
+		if(i > 0)
+		{
+			code = (code + 1) << (codes[i].length - codes[i-1].length);
+		}
+
+		codes[i].code = code;
+	}
+
+	make_node(tree, codes.data(), codes.data() + code_count, 0, frequencies);
+
+	return tree;
+}
+
+} // namespace huffman::canonical
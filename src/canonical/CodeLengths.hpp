@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include "huffman/HuffmanTree.hpp"
+
+namespace huffman::canonical
+{
+
+using code_lengths = std::array<uint8_t, 256>;
+
+/**
+ * @brief						get the length of the longest code in the tree
+ * @throws						nothing
+ */
+size_t tree_depth(const HuffmanTree& tree);
+
+/**
+ * @brief						get the code length of every byte in the tree (0 if the byte is not in the tree)
+ * @throws						nothing
+ */
+code_lengths tree_code_lengths(const HuffmanTree& tree);
+
+/**
+ * @brief						compute optimal code lengths that do not exceed max_length (package-merge)
+ * @param[in]	frequencies		frequency of every byte
+ * @param[in]	max_length		maximum code length
+ * @returns						code length of every byte (0 for bytes with frequency 0, and for the byte of a single-byte input)
+ * @throws						std::invalid_argument if 2^max_length is smaller than the number of bytes that occur
+ * @throws						std::bad_alloc
+ */
+code_lengths limited_code_lengths(const std::array<size_t, 256>& frequencies, size_t max_length);
+
+/**
+ * @brief						compute optimal code lengths that do not exceed max_length (package-merge)
+ * @param[in]	frequencies		frequency of every byte
+ * @param[in]	max_length		maximum code length
+ * @param[in]	resource		memory resource of the package-merge lists, which are freed before returning
+ * @returns						code length of every byte (0 for bytes with frequency 0, and for the byte of a single-byte input)
+ * @throws						std::invalid_argument if 2^max_length is smaller than the number of bytes that occur
+ * @throws						std::bad_alloc
+ */
+code_lengths limited_code_lengths(const std::array<size_t, 256>& frequencies, size_t max_length, std::pmr::memory_resource* resource);
+
+/**
+ * @brief						check if the tree has the shape make_canonical_tree() would give it
+ * @throws						std::bad_alloc
+ */
+bool is_canonical(const HuffmanTree& tree);
+
+/**
+ * @brief						make a tree with canonical codes
+ * @param[in]	lengths			code length of every byte, 0 for bytes not in the tree
+ * @param[in]	frequencies		frequencies stored in the byte nodes
+ * @param[in]	single_byte		byte of the root if no byte has a non-zero code length
+ * @throws						std::invalid_argument if the code lengths do not form a complete prefix code or exceed HuffmanDictionary::code_length_limit
+ */
+HuffmanTree make_canonical_tree(const code_lengths& lengths, const std::array<size_t, 256>& frequencies, char single_byte);
+
+} // namespace huffman::canonical
@@ -0,0 +1,120 @@
+#include <array>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+#include "Endian.hpp"
+#include "Crc32c.hpp"
+
+namespace
+{
+
+// Reflected Castagnoli polynomial
+constexpr uint32_t polynomial = 0x82f63b78;
+
+using crc_tables = std::array<std::array<uint32_t, 256>, 8>;
+
+/**
+ * Table k holds the checksum of every byte followed by k zero bytes, so that 8 bytes
+ * are processed with independent lookups (slicing-by-8)
+ */
+constexpr crc_tables make_tables()
+{
+	crc_tables tables{};
+	for(uint32_t byte = 0; byte < 256; byte++)
+	{
+		uint32_t crc = byte;
+		for(size_t bit = 0; bit < 8; bit++)
+		{
+			crc = (crc >> 1) ^ (crc & 1 ? polynomial : 0);
+		}
+
+		tables[0][byte] = crc;
+	}
+
+	for(size_t table = 1; table < tables.size(); table++)
+	{
+		for(size_t byte = 0; byte < 256; byte++)
+		{
+			uint32_t previous = tables[table - 1][byte];
+			tables[table][byte] = (previous >> 8) ^ tables[0][previous & 0xff];
+		}
+	}
+
+	return tables;
+}
+
+constexpr crc_tables tables = make_tables();
+
+uint32_t update_byte(uint32_t crc, char byte)
+{
+	return (crc >> 8) ^ tables[0][(crc ^ static_cast<unsigned char>(byte)) & 0xff];
+}
+
+} // namespace
+
+namespace huffman::checksum
+{
+
+uint32_t crc32c(uint32_t crc, const char* src, size_t src_size)
+{
+#ifdef HUFFMAN_CHECKSUM_SSE42
+	static const bool sse42 = has_sse42();
+	if(sse42)
+	{
+		return crc32c_sse42(crc, src, src_size);
+	}
+#endif
+
+	return crc32c_generic(crc, src, src_size);
+}
+
+uint32_t crc32c_generic(uint32_t crc, const char* src, size_t src_size)
+{
+	crc = ~crc;
+	for(; src_size >= 8; src += 8, src_size -= 8)
+	{
+		uint64_t word = load_le64(src) ^ crc;
+		crc = tables[7][word & 0xff] ^ tables[6][(word >> 8) & 0xff]
+			^ tables[5][(word >> 16) & 0xff] ^ tables[4][(word >> 24) & 0xff]
+			^ tables[3][(word >> 32) & 0xff] ^ tables[2][(word >> 40) & 0xff]
+			^ tables[1][(word >> 48) & 0xff] ^ tables[0][word >> 56];
+	}
+
+	for(; src_size > 0; src++, src_size--)
+	{
+		crc = update_byte(crc, *src);
+	}
+
+	return ~crc;
+}
+
+#ifdef HUFFMAN_CHECKSUM_SSE42
+
+bool has_sse42()
+{
+	return __builtin_cpu_supports("sse4.2");
+}
+
+__attribute__((target("sse4.2")))
+uint32_t crc32c_sse42(uint32_t crc, const char* src, size_t src_size)
+{
+	uint64_t crc64 = ~crc;
+	for(; src_size >= 8; src += 8, src_size -= 8)
+	{
+		crc64 = _mm_crc32_u64(crc64, load_le64(src));
+	}
+
+	crc = static_cast<uint32_t>(crc64);
+	for(; src_size > 0; src++, src_size--)
+	{
+		crc = _mm_crc32_u8(crc, static_cast<unsigned char>(*src));
+	}
+
+	return ~crc;
+}
+
+#endif
+
+} // namespace huffman::checksum
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define HUFFMAN_CHECKSUM_SSE42 1
+#endif
+
+namespace huffman::checksum
+{
+
+/**
+ * @brief						compute the CRC-32C (Castagnoli) of the source, using the fastest kernel the cpu supports
+ * @param[in]	crc				checksum of the preceding data, 0 to start a new one
+ * @param[in]	src				source
+ * @param[in]	src_size		size of the source
+ * @returns						checksum of the preceding data followed by the source
+ * @throws						nothing
+ */
+uint32_t crc32c(uint32_t crc, const char* src, size_t src_size);
+
+/**
+ * @brief						same as crc32c(), without any cpu specific instructions
+ * @throws						nothing
+ */
+uint32_t crc32c_generic(uint32_t crc, const char* src, size_t src_size);
+
+#ifdef HUFFMAN_CHECKSUM_SSE42
+
+/**
+ * @brief						check if the cpu can run crc32c_sse42()
+ * @throws						nothing
+ */
+bool has_sse42();
+
+/**
+ * @brief						same as crc32c(), using the SSE4.2 crc32 instruction
+ * @throws						nothing
+ */
+uint32_t crc32c_sse42(uint32_t crc, const char* src, size_t src_size);
+
+#endif
+
+} // namespace huffman::checksum
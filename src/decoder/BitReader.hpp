@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "Endian.hpp"
+
+namespace huffman::decoder
+{
+
+class BitReader
+{
+public:
+
+	BitReader(const char* src, size_t src_size, size_t offset)
+	: m_src{src},
+	  m_bits_processed{std::min(offset, src_size*8)},
+	  m_total_bits{src_size*8}
+	{
+
+	}
+
+	bool empty() const
+	{
+		return m_bits_processed == m_total_bits;
+	}
+
+	size_t bitsProcessed() const
+	{
+		return m_bits_processed;
+	}
+
+	size_t bitsLeft() const
+	{
+		return m_total_bits - m_bits_processed;
+	}
+
+	size_t maxBits() const
+	{
+		return m_total_bits;
+	}
+
+	const char* data() const
+	{
+		return m_src;
+	}
+
+	/**
+	 * @brief					read bits without consuming them
+	 * @param[in]	skip		number of bits to skip before reading
+	 * @param[in]	count		number of bits to read (at most 57)
+	 * @returns					the bits, first bit in the least significant position; bits past the end read as 0
+	 */
+	uint64_t peek(size_t skip, size_t count) const
+	{
+		size_t position = m_bits_processed + skip;
+		size_t index = position / 8;
+		size_t total_bytes = m_total_bits / 8;
+
+		uint64_t bits = 0;
+		if(index + 8 <= total_bytes)
+		{
+			bits = load_le64(m_src + index);
+		}
+		else
+		{
+			for(size_t i = 0; index + i < total_bytes; i++)
+			{
+				bits |= uint64_t{static_cast<unsigned char>(m_src[index + i])} << (i*8);
+			}
+		}
+
+		bits >>= position % 8;
+
+		return bits & ((uint64_t{1} << count) - 1);
+	}
+
+	void consume(size_t count)
+	{
+		m_bits_processed = std::min(m_bits_processed + count, m_total_bits);
+	}
+
+private:
+	const char* m_src;
+	size_t m_bits_processed;
+	const size_t m_total_bits;
+};
+
+} // namespace huffman::decoder
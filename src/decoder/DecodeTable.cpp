@@ -0,0 +1,68 @@
+#include <algorithm>
+
+#include "huffman/HuffmanTree.hpp"
+#include "DecodeTable.hpp"
+
+namespace huffman::decoder
+{
+
+DecodeTable::DecodeTable(const HuffmanTree& tree)
+	: DecodeTable(tree, std::pmr::get_default_resource())
+{
+
+}
+
+DecodeTable::DecodeTable(const HuffmanTree& tree, std::pmr::memory_resource* resource)
+	: m_entries(resource), m_depths{}, m_root_bits{0}, m_max_length{0}
+{
+	// Children are stored before their parents
+	for(HuffmanTree::index_type i = 0; i < tree.node_count(); i++)
+	{
+		if(!tree.is_byte_node(i))
+		{
+			m_depths[i] = static_cast<uint8_t>(1 + std::max(m_depths[tree.left(i)], m_depths[tree.right(i)]));
+		}
+	}
+
+	m_max_length = m_depths[tree.root()];
+	m_root_bits = std::min<size_t>(m_max_length, max_root_bits);
+	makeTable(tree, tree.root(), m_root_bits);
+}
+
+size_t DecodeTable::makeTable(const HuffmanTree& tree, HuffmanTree::index_type node, size_t table_bits)
+{
+	size_t table = m_entries.size();
+
+	m_entries.resize(table + (size_t{1} << table_bits));
+	fill(tree, node, table, table_bits, 0, 0);
+
+	return table;
+}
+
+void DecodeTable::fill(const HuffmanTree& tree, HuffmanTree::index_type node, size_t table, size_t table_bits, uint32_t code, size_t length)
+{
+	if(tree.is_byte_node(node))
+	{
+		// Every index that starts with the code decodes to the same byte
+		Entry entry{static_cast<unsigned char>(tree.byte(node)), static_cast<uint8_t>(length), false};
+		for(size_t i = code; i < (size_t{1} << table_bits); i += size_t{1} << length)
+		{
+			m_entries[table + i] = entry;
+		}
+	}
+	else if(length == table_bits)
+	{
+		// The code is longer than the index of this table, continue in a sub-table
+		size_t sub_table_bits = std::min<size_t>(m_depths[node], max_root_bits);
+		size_t sub_table = makeTable(tree, node, sub_table_bits);
+
+		m_entries[table + code] = {static_cast<uint32_t>(sub_table), static_cast<uint8_t>(sub_table_bits), true};
+	}
+	else
+	{
+		fill(tree, tree.left(node), table, table_bits, code | (uint32_t{1} << length), length+1);
+		fill(tree, tree.right(node), table, table_bits, code, length+1);
+	}
+}
+
+} // namespace huffman::decoder
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include "huffman/HuffmanTree.hpp"
+
+namespace huffman::decoder
+{
+
+/**
+ * Multi-level lookup table built from a huffman tree.
+ *
+ * The root table is indexed by the next rootBits() bits of the input. Codes that do not fit
+ * in the root table continue in sub-tables, each indexed by the bits that follow.
+ */
+class DecodeTable
+{
+public:
+	static constexpr size_t max_root_bits = 11;
+
+	struct Entry
+	{
+		uint32_t value;	// decoded byte for leaves, offset of the sub-table for links
+		uint8_t length;	// bits used by the leaf at this level, index width of the sub-table for links
+		bool is_link;
+	};
+
+	explicit DecodeTable(const HuffmanTree& tree);
+	DecodeTable(const HuffmanTree& tree, std::pmr::memory_resource* resource);
+
+	size_t rootBits() const
+	{
+		return m_root_bits;
+	}
+
+	/// Length of the longest code
+	size_t maxLength() const
+	{
+		return m_max_length;
+	}
+
+	const Entry& operator[](size_t index) const
+	{
+		return m_entries[index];
+	}
+
+	size_t size() const
+	{
+		return m_entries.size();
+	}
+
+private:
+	void fill(const HuffmanTree& tree, HuffmanTree::index_type node, size_t table, size_t table_bits, uint32_t code, size_t length);
+	size_t makeTable(const HuffmanTree& tree, HuffmanTree::index_type node, size_t table_bits);
+
+	std::pmr::vector<Entry> m_entries;
+	std::array<uint8_t, HuffmanTree::max_nodes> m_depths;
+	size_t m_root_bits;
+	size_t m_max_length;
+};
+
+} // namespace huffman::decoder
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include "BitReader.hpp"
+#include "DecodeTable.hpp"
+#include "Endian.hpp"
+#include "TableDecoder.hpp"
+
+namespace huffman::decoder
+{
+
+/**
+ * Decodes 4 independent streams in one loop.
+ *
+ * Where a code starts in a stream depends on the length of the previous code, so a single
+ * stream is decoded one code at a time. Codes of different streams do not depend on each
+ * other, so the cpu works on all 4 at once.
+ */
+class InterleavedDecoder
+{
+public:
+	static constexpr size_t stream_count = 4;
+
+	InterleavedDecoder(const std::array<BitReader, stream_count>& readers, const DecodeTable& table)
+		: m_readers{readers}, m_table{table}
+	{
+
+	}
+
+	/**
+	 * @brief				decode sizes[i] bytes of stream i to dst[i]
+	 * @returns				false if a stream ends before all of its bytes are decoded
+	 */
+	bool decode(const std::array<char*, stream_count>& dst, const std::array<size_t, stream_count>& sizes)
+	{
+		size_t common_size = *std::min_element(sizes.begin(), sizes.end());
+		size_t decoded = decodeFast(dst, common_size);
+		bool complete = true;
+
+		// The ends of the streams are decoded one stream at a time, with bounds checks
+		for(size_t stream = 0; stream < stream_count; stream++)
+		{
+			TableDecoder decoder(m_readers[stream], m_table);
+			size_t rest = sizes[stream] - decoded;
+			complete &= decoder.decode(dst[stream] + decoded, rest) == rest;
+		}
+
+		return complete;
+	}
+
+private:
+	/**
+	 * @brief				decode size bytes of every stream without bounds checks while 8 bytes can be loaded
+	 *						at the current position of all streams
+	 * @returns				number of bytes written to every dst[i], the rest of the input is left to decode()
+	 * @note				same as TableDecoder::decodeFast() on all streams at once
+	 */
+	size_t decodeFast(const std::array<char*, stream_count>& dst, size_t size)
+	{
+		const size_t max_length = m_table.maxLength();
+		if(max_length > 57)
+		{
+			return 0;
+		}
+
+		// Kept in locals, stores to dst may alias anything reached through m_table or m_readers
+		std::array<const char*, stream_count> src{};
+		std::array<size_t, stream_count> last_load{};
+		std::array<size_t, stream_count> position{};
+		for(size_t stream = 0; stream < stream_count; stream++)
+		{
+			size_t src_size = m_readers[stream].maxBits() / 8;
+			if(src_size < 8)
+			{
+				return 0;
+			}
+
+			src[stream] = m_readers[stream].data();
+			last_load[stream] = src_size - 8;
+			position[stream] = m_readers[stream].bitsProcessed();
+		}
+
+		const DecodeTable::Entry* entries = &m_table[0];
+		const size_t root_bits = m_table.rootBits();
+		const size_t root_mask = (size_t{1} << root_bits) - 1;
+		size_t di = 0;
+
+		while(di < size && position[0] / 8 <= last_load[0] && position[1] / 8 <= last_load[1]
+			&& position[2] / 8 <= last_load[2] && position[3] / 8 <= last_load[3])
+		{
+			std::array<uint64_t, stream_count> bits{};
+			size_t available = 64;
+			for(size_t stream = 0; stream < stream_count; stream++)
+			{
+				bits[stream] = load_le64(src[stream] + position[stream] / 8) >> (position[stream] % 8);
+				available = std::min(available, 64 - position[stream] % 8);
+			}
+
+			// Every stream has at least the longest code left in its bits, so all of them take one
+			std::array<size_t, stream_count> used{};
+			do
+			{
+				for(size_t stream = 0; stream < stream_count; stream++)
+				{
+					const DecodeTable::Entry* entry = &entries[bits[stream] & root_mask];
+					size_t table_bits = root_bits;
+					size_t code_bits = 0;
+					while(entry->is_link)
+					{
+						code_bits += table_bits;
+						table_bits = entry->length;
+						entry = &entries[entry->value + ((bits[stream] >> code_bits) & ((size_t{1} << table_bits) - 1))];
+					}
+
+					size_t length = code_bits + entry->length;
+					dst[stream][di] = static_cast<char>(entry->value);
+					bits[stream] >>= length;
+					used[stream] += length;
+				}
+
+				di++;
+			}
+			while(available - std::max({used[0], used[1], used[2], used[3]}) >= max_length && di < size);
+
+			for(size_t stream = 0; stream < stream_count; stream++)
+			{
+				position[stream] += used[stream];
+			}
+		}
+
+		for(size_t stream = 0; stream < stream_count; stream++)
+		{
+			m_readers[stream].consume(position[stream] - m_readers[stream].bitsProcessed());
+		}
+
+		return di;
+	}
+
+	std::array<BitReader, stream_count> m_readers;
+	const DecodeTable& m_table;
+};
+
+} // namespace huffman::decoder
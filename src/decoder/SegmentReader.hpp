@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "Endian.hpp"
+
+namespace huffman::decoder
+{
+
+/**
+ * Reads bits from a list of source buffers as if they were one, so a code may start in one
+ * buffer and end in the next one. Has the same interface as BitReader.
+ */
+class SegmentReader
+{
+public:
+
+	explicit SegmentReader(std::span<const std::span<const std::byte>> segments)
+	: m_segments{segments},
+	  m_segment{0},
+	  m_position{0},
+	  m_bits_processed{0},
+	  m_total_bits{0}
+	{
+		for(std::span<const std::byte> segment : segments)
+		{
+			m_total_bits += segment.size()*8;
+		}
+
+		skipFinished();
+	}
+
+	bool empty() const
+	{
+		return m_bits_processed == m_total_bits;
+	}
+
+	size_t bitsProcessed() const
+	{
+		return m_bits_processed;
+	}
+
+	size_t bitsLeft() const
+	{
+		return m_total_bits - m_bits_processed;
+	}
+
+	size_t maxBits() const
+	{
+		return m_total_bits;
+	}
+
+	/**
+	 * @brief					read bits without consuming them
+	 * @param[in]	skip		number of bits to skip before reading
+	 * @param[in]	count		number of bits to read (at most 57)
+	 * @returns					the bits, first bit in the least significant position; bits past the end read as 0
+	 */
+	uint64_t peek(size_t skip, size_t count) const
+	{
+		size_t segment = m_segment;
+		size_t position = m_position + skip;
+		while(segment < m_segments.size() && position >= m_segments[segment].size()*8)
+		{
+			position -= m_segments[segment].size()*8;
+			segment++;
+		}
+
+		size_t index = position / 8;
+
+		uint64_t bits = 0;
+		if(segment < m_segments.size() && index + 8 <= m_segments[segment].size())
+		{
+			bits = load_le64(reinterpret_cast<const char*>(m_segments[segment].data()) + index);
+		}
+		else
+		{
+			// The 8 bytes continue in the next segments
+			for(size_t i = 0; i < 8 && segment < m_segments.size(); index = 0, segment++)
+			{
+				for(; i < 8 && index < m_segments[segment].size(); i++, index++)
+				{
+					bits |= uint64_t{static_cast<unsigned char>(m_segments[segment][index])} << (i*8);
+				}
+			}
+		}
+
+		bits >>= position % 8;
+
+		return bits & ((uint64_t{1} << count) - 1);
+	}
+
+	void consume(size_t count)
+	{
+		count = std::min(count, m_total_bits - m_bits_processed);
+		m_bits_processed += count;
+		m_position += count;
+		skipFinished();
+	}
+
+private:
+	/**
+	 * @brief					move past the segments that are fully read
+	 */
+	void skipFinished()
+	{
+		while(m_segment < m_segments.size() && m_position >= m_segments[m_segment].size()*8)
+		{
+			m_position -= m_segments[m_segment].size()*8;
+			m_segment++;
+		}
+	}
+
+	std::span<const std::span<const std::byte>> m_segments;
+	size_t m_segment;
+	size_t m_position;	// bits read from the current segment
+	size_t m_bits_processed;
+	size_t m_total_bits;
+};
+
+} // namespace huffman::decoder
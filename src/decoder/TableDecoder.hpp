@@ -0,0 +1,158 @@
+#pragma once
+
+#include <type_traits>
+#include "BitReader.hpp"
+#include "DecodeTable.hpp"
+#include "Endian.hpp"
+
+namespace huffman::decoder
+{
+
+/**
+ * Decodes one code at a time with a DecodeTable, reading the bits from a BitReader or from a
+ * reader with the same interface (SegmentReader).
+ */
+template<typename Reader = BitReader>
+class TableDecoder
+{
+public:
+
+	TableDecoder(const Reader& reader, const DecodeTable& table)
+		: m_reader{reader}, m_table{table}
+	{
+
+	}
+
+	/**
+	 * @brief				decode a single byte
+	 * @returns				decoded byte (first) and false if the input ends before the code is complete (second)
+	 */
+	std::pair<char, bool> decode()
+	{
+		size_t table = 0;
+		size_t table_bits = m_table.rootBits();
+		size_t code_bits = 0;
+
+		while(true)
+		{
+			const DecodeTable::Entry& entry = m_table[table + m_reader.peek(code_bits, table_bits)];
+
+			if(!entry.is_link)
+			{
+				code_bits += entry.length;
+				if(code_bits > m_reader.bitsLeft())
+				{
+					return {'\0', false};
+				}
+
+				m_reader.consume(code_bits);
+				return {static_cast<char>(entry.value), true};
+			}
+
+			code_bits += table_bits;
+			if(code_bits > m_reader.bitsLeft())
+			{
+				return {'\0', false};
+			}
+
+			table = entry.value;
+			table_bits = entry.length;
+		}
+	}
+
+	/**
+	 * @brief				decode bytes until dst is full or the input ends
+	 * @returns				number of bytes written to dst
+	 */
+	size_t decode(char* dst, size_t dst_size)
+	{
+		size_t di = 0;
+		if constexpr(std::is_same_v<Reader, BitReader>)
+		{
+			di = decodeFast(dst, dst_size);
+		}
+
+		for(; di < dst_size; di++)
+		{
+			auto[byte, is_set] = decode();
+			if(!is_set)
+			{
+				return di;
+			}
+
+			dst[di] = byte;
+		}
+
+		return dst_size;
+	}
+
+	size_t bitsProcessed() const
+	{
+		return m_reader.bitsProcessed();
+	}
+
+	size_t maxBits() const
+	{
+		return m_reader.maxBits();
+	}
+
+private:
+	/**
+	 * @brief				decode bytes without bounds checks while 8 bytes can be loaded at the current position
+	 * @returns				number of bytes written to dst, the rest of the input is left to the checked decode()
+	 * @note				every load gives at least 57 bits, so codes are decoded from it while at least the
+	 *						longest code is left, without checking the end of the input
+	 */
+	size_t decodeFast(char* dst, size_t dst_size)
+	{
+		const size_t max_length = m_table.maxLength();
+		const size_t src_size = m_reader.maxBits() / 8;
+		if(max_length > 57 || src_size < 8)
+		{
+			return 0;
+		}
+
+		// Kept in locals, stores to dst may alias anything reached through m_table
+		const char* src = m_reader.data();
+		const DecodeTable::Entry* entries = &m_table[0];
+		const size_t root_bits = m_table.rootBits();
+		const size_t root_mask = (size_t{1} << root_bits) - 1;
+		const size_t last_load = src_size - 8;
+		size_t position = m_reader.bitsProcessed();
+		size_t di = 0;
+
+		while(di < dst_size && position / 8 <= last_load)
+		{
+			uint64_t bits = load_le64(src + position / 8) >> (position % 8);
+			size_t available = 64 - position % 8;
+
+			do
+			{
+				const DecodeTable::Entry* entry = &entries[bits & root_mask];
+				size_t table_bits = root_bits;
+				size_t code_bits = 0;
+				while(entry->is_link)
+				{
+					code_bits += table_bits;
+					table_bits = entry->length;
+					entry = &entries[entry->value + ((bits >> code_bits) & ((size_t{1} << table_bits) - 1))];
+				}
+
+				size_t length = code_bits + entry->length;
+				dst[di++] = static_cast<char>(entry->value);
+				bits >>= length;
+				available -= length;
+				position += length;
+			}
+			while(available >= max_length && di < dst_size);
+		}
+
+		m_reader.consume(position - m_reader.bitsProcessed());
+		return di;
+	}
+
+	Reader m_reader;
+	const DecodeTable& m_table;
+};
+
+} // namespace huffman::decoder
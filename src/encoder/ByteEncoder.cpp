@@ -1,47 +1,16 @@
-#include <array>
-#include "huffman/HuffmanNode.hpp"
+#include "huffman/HuffmanTree.hpp"
 #include "ByteEncoder.hpp"
 #include "ByteWriter.hpp"
+#include "CodeTable.hpp"
 #include "encoder/ByteEncoder.hpp"
 
-namespace
-{
-
-uint64_t reverse_code(uint64_t code, size_t depth)
-{
-	uint64_t new_code = 0;
-	while(depth--)
-	{
-		new_code |= (code & 1) << depth;
-		code >>= 1;
-	}
-
-	return new_code;
-}
-
-void make_lookup_table(const huffman::HuffmanNode& node, std::array<std::pair<uint64_t, size_t>, 256>& lookup_table, uint64_t code, size_t depth)
-{
-	if(node.is_byte_node())
-	{
-		lookup_table[static_cast<unsigned char>(node.byte())] = std::make_pair(reverse_code(code, depth), depth);
-	}
-	else
-	{
-		make_lookup_table(*node.left(), lookup_table, (code << 1) | 1, depth+1);
-		make_lookup_table(*node.right(), lookup_table, code << 1, depth+1);
-	}
-}
-
-} // namespace
-
 namespace huffman::encoder
 {
 
-ByteEncoder::ByteEncoder(const ByteWriter& writer, const HuffmanNode& root_node)
-	: m_writer{writer}
+ByteEncoder::ByteEncoder(const ByteWriter& writer, const HuffmanTree& tree)
+	: m_writer{writer}, m_lookup_table{make_code_table(tree)}
 {
-	// TODO: init lookup table
-	make_lookup_table(root_node, m_lookup_table, 0, 0);
+
 }
 
 bool ByteEncoder::encode(char byte)
@@ -51,6 +20,11 @@ bool ByteEncoder::encode(char byte)
 	return m_writer.write(code, length);
 }
 
+void ByteEncoder::flush()
+{
+	m_writer.flush();
+}
+
 size_t ByteEncoder::bitsWritten() const
 {
 	return m_writer.bitsWritten();
@@ -61,4 +35,4 @@ size_t ByteEncoder::maxBits() const
 	return m_writer.maxBits();
 }
 
-} // namespace huffman::encoder
\ No newline at end of file
+} // namespace huffman::encoder
@@ -1,8 +1,8 @@
 #pragma once
 
-#include <array>
-#include "huffman/HuffmanNode.hpp"
+#include "huffman/HuffmanTree.hpp"
 #include "encoder/ByteWriter.hpp"
+#include "encoder/CodeTable.hpp"
 
 namespace huffman::encoder
 {
@@ -10,16 +10,17 @@ namespace huffman::encoder
 class ByteEncoder
 {
 public:
-	ByteEncoder(const ByteWriter& writer, const HuffmanNode& root_node);
+	ByteEncoder(const ByteWriter& writer, const HuffmanTree& tree);
 
 	bool encode(char byte);
+	void flush();
 
 	size_t bitsWritten() const;
 	size_t maxBits() const;
 
 private:
 	ByteWriter m_writer;
-	std::array<std::pair<uint64_t, size_t>, 256> m_lookup_table{};
+	code_table m_lookup_table;
 };
 
 } // namespace huffman::encoder
\ No newline at end of file
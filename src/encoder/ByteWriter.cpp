@@ -1,21 +1,17 @@
 #include <algorithm>
 
 #include "ByteWriter.hpp"
-#include "encoder/ByteWriter.hpp"
+#include "Endian.hpp"
 
 namespace
 {
 
-std::pair<char, size_t> encode_byte(char byte, size_t bits_set, uint64_t& code, size_t& length)
-{
-	char real_byte = static_cast<char>(byte & ~(0xff << bits_set));
-	size_t bits_written = std::min(8-bits_set, length);
-
-	real_byte |= static_cast<char>(code << bits_set);
-	length -= bits_written;
-	code >>= bits_written;
+// Keeps the buffer from overflowing: at most 7 pending bits + 32 new bits
+constexpr size_t max_chunk_length = 32;
 
-	return {real_byte, bits_set + bits_written};
+uint64_t low_bits(uint64_t value, size_t count)
+{
+	return count < 64 ? value & ((uint64_t{1} << count) - 1) : value;
 }
 
 } // namespace
@@ -25,15 +21,23 @@ namespace huffman::encoder
 
 ByteWriter::ByteWriter(char* dst, size_t dst_size, size_t offset)
 	: m_dst{dst},
+	  m_end{dst + dst_size},
+	  m_buffer{0},
+	  m_buffered{0},
 	  m_bits_written{offset},
-	  m_shift{offset%8},
 	  m_total_bits{dst_size*8}
 {
-	dst += offset / 8;
-	if(offset > m_total_bits)
+	if(offset >= m_total_bits)
 	{
 		m_bits_written = m_total_bits;
+		m_dst = m_end;
+		return;
 	}
+
+	// Keep the bits that are already used in the partially written byte
+	m_dst += offset / 8;
+	m_buffered = offset % 8;
+	m_buffer = low_bits(static_cast<unsigned char>(*m_dst), m_buffered);
 }
 
 size_t ByteWriter::bitsWritten() const
@@ -62,18 +66,46 @@ bool ByteWriter::write(uint64_t code, size_t length)
 
 	while(length)
 	{
-		auto[byte, new_shift] = encode_byte(*m_dst, m_shift, code, length);
+		size_t chunk_length = std::min(length, max_chunk_length);
+
+		m_buffer |= low_bits(code, chunk_length) << m_buffered;
+		m_buffered += chunk_length;
+		store();
+
+		code = chunk_length < 64 ? code >> chunk_length : 0;
+		length -= chunk_length;
+	}
+
+	return true;
+}
+
+void ByteWriter::flush()
+{
+	if(m_buffered)
+	{
+		*m_dst = static_cast<char>(m_buffer);
+	}
+}
 
-		*m_dst = byte;
-		m_shift = new_shift % 8;
+void ByteWriter::store()
+{
+	size_t full_bytes = m_buffered / 8;
 
-		if(m_shift == 0)
+	if(m_end - m_dst >= 8)
+	{
+		store_le64(m_dst, m_buffer);
+	}
+	else
+	{
+		for(size_t i = 0; i < full_bytes; i++)
 		{
-			m_dst++;
+			m_dst[i] = static_cast<char>(m_buffer >> (i*8));
 		}
 	}
 
-	return true;
+	m_dst += full_bytes;
+	m_buffer >>= full_bytes*8;
+	m_buffered %= 8;
 }
 
-} // namespace huffman::encoder
\ No newline at end of file
+} // namespace huffman::encoder
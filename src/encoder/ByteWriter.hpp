@@ -6,6 +6,11 @@
 namespace huffman::encoder
 {
 
+/**
+ * Collects codes in a 64-bit buffer and stores whole words while there are at least 8 bytes
+ * left in dst; the last bytes are stored one at a time. Bytes past the last written bit may be
+ * overwritten. Call flush() to store the partially written last byte.
+ */
 class ByteWriter
 {
 public:
@@ -17,12 +22,17 @@ public:
 	bool empty() const;
 
 	bool write(uint64_t code, size_t length);
+	void flush();
 
 private:
+	void store();
+
 	char* m_dst;
+	char* m_end;
+	uint64_t m_buffer;
+	size_t m_buffered;
 	size_t m_bits_written;
-	size_t m_shift;
 	const size_t m_total_bits;
 };
 
-} // namespace huffman::encoder
\ No newline at end of file
+} // namespace huffman::encoder
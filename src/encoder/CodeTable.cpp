@@ -0,0 +1,50 @@
+#include <stdexcept>
+#include "CodeTable.hpp"
+
+namespace
+{
+
+uint64_t reverse_code(uint64_t code, size_t depth)
+{
+	uint64_t new_code = 0;
+	while(depth--)
+	{
+		new_code |= (code & 1) << depth;
+		code >>= 1;
+	}
+
+	return new_code;
+}
+
+void make_lookup_table(const huffman::HuffmanTree& tree, huffman::HuffmanTree::index_type node, huffman::encoder::code_table& lookup_table, uint64_t code, size_t depth)
+{
+	if(depth > 64)
+	{
+		throw std::length_error("huffman code does not fit in 64 bits");
+	}
+
+	if(tree.is_byte_node(node))
+	{
+		lookup_table[static_cast<unsigned char>(tree.byte(node))] = std::make_pair(reverse_code(code, depth), depth);
+	}
+	else
+	{
+		make_lookup_table(tree, tree.left(node), lookup_table, (code << 1) | 1, depth+1);
+		make_lookup_table(tree, tree.right(node), lookup_table, code << 1, depth+1);
+	}
+}
+
+} // namespace
+
+namespace huffman::encoder
+{
+
+code_table make_code_table(const HuffmanTree& tree)
+{
+	code_table table{};
+	make_lookup_table(tree, tree.root(), table, 0, 0);
+
+	return table;
+}
+
+} // namespace huffman::encoder
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "huffman/HuffmanTree.hpp"
+
+namespace huffman::encoder
+{
+
+/// Code (first bit in the least significant position) and its length for every byte, length 0 for bytes not in the tree
+using code_table = std::array<std::pair<uint64_t, size_t>, 256>;
+
+/**
+ * @brief				get the code of every byte in the tree
+ * @throws				std::length_error if a code does not fit in 64 bits
+ */
+code_table make_code_table(const HuffmanTree& tree);
+
+} // namespace huffman::encoder
@@ -0,0 +1,120 @@
+#include <algorithm>
+
+#include "SegmentWriter.hpp"
+#include "Endian.hpp"
+
+namespace
+{
+
+// Keeps the buffer from overflowing: at most 7 pending bits + 32 new bits
+constexpr size_t max_chunk_length = 32;
+
+uint64_t low_bits(uint64_t value, size_t count)
+{
+	return count < 64 ? value & ((uint64_t{1} << count) - 1) : value;
+}
+
+} // namespace
+
+namespace huffman::encoder
+{
+
+SegmentWriter::SegmentWriter(std::span<const std::span<std::byte>> segments)
+	: m_segments{segments},
+	  m_segment{0},
+	  m_position{0},
+	  m_buffer{0},
+	  m_buffered{0},
+	  m_bits_written{0},
+	  m_total_bits{0}
+{
+	for(std::span<std::byte> segment : segments)
+	{
+		m_total_bits += segment.size()*8;
+	}
+
+	skipFull();
+}
+
+size_t SegmentWriter::bitsWritten() const
+{
+	return m_bits_written;
+}
+
+size_t SegmentWriter::maxBits() const
+{
+	return m_total_bits;
+}
+
+bool SegmentWriter::empty() const
+{
+	return m_bits_written == m_total_bits;
+}
+
+bool SegmentWriter::write(uint64_t code, size_t length)
+{
+	if(length > m_total_bits - m_bits_written)
+	{
+		return false;
+	}
+
+	m_bits_written += length;
+
+	while(length)
+	{
+		size_t chunk_length = std::min(length, max_chunk_length);
+
+		m_buffer |= low_bits(code, chunk_length) << m_buffered;
+		m_buffered += chunk_length;
+		store();
+
+		code = chunk_length < 64 ? code >> chunk_length : 0;
+		length -= chunk_length;
+	}
+
+	return true;
+}
+
+void SegmentWriter::flush()
+{
+	if(m_buffered)
+	{
+		m_segments[m_segment][m_position] = static_cast<std::byte>(m_buffer);
+	}
+}
+
+void SegmentWriter::store()
+{
+	size_t full_bytes = m_buffered / 8;
+
+	if(m_segments[m_segment].size() - m_position >= 8)
+	{
+		store_le64(reinterpret_cast<char*>(m_segments[m_segment].data()) + m_position, m_buffer);
+		m_position += full_bytes;
+		m_buffer >>= full_bytes*8;
+	}
+	else
+	{
+		// The bytes continue in the next segments
+		for(size_t i = 0; i < full_bytes; i++)
+		{
+			m_segments[m_segment][m_position++] = static_cast<std::byte>(m_buffer);
+			m_buffer >>= 8;
+			skipFull();
+		}
+	}
+
+	m_buffered %= 8;
+	skipFull();
+}
+
+void SegmentWriter::skipFull()
+{
+	while(m_segment + 1 < m_segments.size() && m_position == m_segments[m_segment].size())
+	{
+		m_position = 0;
+		m_segment++;
+	}
+}
+
+} // namespace huffman::encoder
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace huffman::encoder
+{
+
+/**
+ * Writes codes to a list of destination buffers as if they were one, so a code may start in
+ * one buffer and end in the next one. Stores whole words while there are at least 8 bytes left
+ * in the current buffer, like ByteWriter, so bytes past the last written bit may be
+ * overwritten. Call flush() to store the partially written last byte.
+ */
+class SegmentWriter
+{
+public:
+	explicit SegmentWriter(std::span<const std::span<std::byte>> segments);
+
+	size_t bitsWritten() const;
+	size_t maxBits() const;
+
+	bool empty() const;
+
+	bool write(uint64_t code, size_t length);
+	void flush();
+
+private:
+	void store();
+	void skipFull();
+
+	std::span<const std::span<std::byte>> m_segments;
+	size_t m_segment;
+	size_t m_position;	// bytes stored to the current segment
+	uint64_t m_buffer;
+	size_t m_buffered;
+	size_t m_bits_written;
+	size_t m_total_bits;
+};
+
+} // namespace huffman::encoder
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <array>
+
+#include "Stream.hpp"
+#include "histogram/Histogram.hpp"
+#include "Endian.hpp"
+
+namespace huffman::encoder
+{
+
+size_t encoded_size(const canonical::code_lengths& lengths, const char* src, size_t src_size)
+{
+	histogram::byte_frequencies byte_frequencies{};
+	histogram::count(byte_frequencies, src, src_size);
+
+	size_t bits = 0;
+	for(size_t i = 0; i < byte_frequencies.size(); i++)
+	{
+		bits += byte_frequencies[i] * lengths[i];
+	}
+
+	return (bits + 7) / 8;
+}
+
+size_t encoded_size(const code_table& codes, const char* src, size_t src_size)
+{
+	size_t bits = 0;
+	for(size_t si = 0; si < src_size; si++)
+	{
+		bits += codes[static_cast<unsigned char>(src[si])].second;
+	}
+
+	return (bits + 7) / 8;
+}
+
+void encode_stream(const code_table& codes, const char* src, size_t src_size, char* dst, size_t dst_size)
+{
+	char* const end = dst + dst_size;
+	uint64_t buffer = 0;
+	size_t buffered = 0;
+
+	// Less than 32 bits are buffered before every chunk of at most 32 bits, so the buffer never overflows
+	auto put = [&](uint64_t chunk, size_t length)
+	{
+		buffer |= chunk << buffered;
+		buffered += length;
+		if(buffered >= 32)
+		{
+			store_le32(dst, static_cast<uint32_t>(buffer));
+			dst += 4;
+			buffer >>= 32;
+			buffered -= 32;
+		}
+	};
+
+	for(size_t si = 0; si < src_size; si++)
+	{
+		auto[code, length] = codes[static_cast<unsigned char>(src[si])];
+		if(length > 32)
+		{
+			put(code & 0xffffffff, 32);
+			put(code >> 32, length - 32);
+		}
+		else
+		{
+			put(code, length);
+		}
+	}
+
+	// Store the bytes left in the buffer, the last one may be partial
+	size_t tail = std::min<size_t>((buffered + 7) / 8, static_cast<size_t>(end - dst));
+	for(size_t i = 0; i < tail; i++)
+	{
+		dst[i] = static_cast<char>(buffer >> (i*8));
+	}
+}
+
+} // namespace huffman::encoder
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include "canonical/CodeLengths.hpp"
+#include "CodeTable.hpp"
+
+namespace huffman::encoder
+{
+
+/**
+ * @brief						get the number of bytes the source takes once encoded with the given code lengths
+ * @throws						nothing
+ */
+size_t encoded_size(const canonical::code_lengths& lengths, const char* src, size_t src_size);
+
+/**
+ * @brief						get the number of bytes the source takes once encoded with the given codes
+ * @throws						nothing
+ * @note						adds up the code lengths one byte at a time, which is faster than a histogram for short sources
+ */
+size_t encoded_size(const code_table& codes, const char* src, size_t src_size);
+
+/**
+ * @brief						encode the source into a stream that starts at a byte boundary
+ * @param[in]	codes			code table of the dictionary
+ * @param[in]	dst_size		size from encoded_size()
+ * @throws						nothing
+ * @note						dst_size is trusted, so no bounds are checked while encoding
+ */
+void encode_stream(const code_table& codes, const char* src, size_t src_size, char* dst, size_t dst_size);
+
+} // namespace huffman::encoder
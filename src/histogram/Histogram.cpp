@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+#include "Endian.hpp"
+#include "Parallel.hpp"
+#include "Histogram.hpp"
+
+namespace
+{
+
+using huffman::histogram::byte_frequencies;
+
+/**
+ * Counts spread over several tables, so that runs of one byte do not wait for the previous increment
+ * of the same counter. Counters are 32-bit to keep the tables in L1 and are spilled into the
+ * frequencies before they can overflow.
+ */
+template<size_t TableCount>
+class SubHistograms
+{
+public:
+	// No counter can overflow while counting this many bytes
+	static constexpr size_t max_chunk_size = size_t{1} << 31;
+
+	void add(uint64_t bytes)
+	{
+		m_tables[0 % TableCount][bytes & 0xff]++;
+		m_tables[1 % TableCount][(bytes >> 8) & 0xff]++;
+		m_tables[2 % TableCount][(bytes >> 16) & 0xff]++;
+		m_tables[3 % TableCount][(bytes >> 24) & 0xff]++;
+		m_tables[4 % TableCount][(bytes >> 32) & 0xff]++;
+		m_tables[5 % TableCount][(bytes >> 40) & 0xff]++;
+		m_tables[6 % TableCount][(bytes >> 48) & 0xff]++;
+		m_tables[7 % TableCount][bytes >> 56]++;
+	}
+
+	void add(size_t table, unsigned char byte, uint32_t count)
+	{
+		m_tables[table % TableCount][byte] += count;
+	}
+
+	void spill(byte_frequencies& frequencies)
+	{
+		for(size_t byte = 0; byte < frequencies.size(); byte++)
+		{
+			size_t total = 0;
+			for(auto& table : m_tables)
+			{
+				total += table[byte];
+				table[byte] = 0;
+			}
+
+			frequencies[byte] += total;
+		}
+	}
+
+private:
+	std::array<std::array<uint32_t, 256>, TableCount> m_tables{};
+};
+
+// Smallest part worth starting a thread for
+constexpr size_t min_thread_part_size = size_t{1} << 16;
+
+// Below this size clearing and spilling the tables costs more than it saves
+constexpr size_t min_table_size = 1024;
+
+void count_simple(byte_frequencies& frequencies, const char* src, size_t src_size)
+{
+	for(size_t i = 0; i < src_size; i++)
+	{
+		frequencies[static_cast<unsigned char>(src[i])]++;
+	}
+}
+
+#ifdef HUFFMAN_HISTOGRAM_AVX2
+
+__attribute__((target("avx2")))
+void count_avx2_chunk(SubHistograms<8>& tables, const char* src, size_t size)
+{
+	size_t i = 0;
+	for(; i + 32 <= size; i += 32)
+	{
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i_u*>(src + i));
+		__m256i first = _mm256_set1_epi8(src[i]);
+
+		// Runs of one byte are counted at once
+		if(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, first)) == -1)
+		{
+			tables.add(0, static_cast<unsigned char>(src[i]), 32);
+			continue;
+		}
+
+		tables.add(huffman::load_le64(src + i));
+		tables.add(huffman::load_le64(src + i + 8));
+		tables.add(huffman::load_le64(src + i + 16));
+		tables.add(huffman::load_le64(src + i + 24));
+	}
+
+	for(; i < size; i++)
+	{
+		tables.add(i, static_cast<unsigned char>(src[i]), 1);
+	}
+}
+
+#endif
+
+} // namespace
+
+namespace huffman::histogram
+{
+
+void count(byte_frequencies& frequencies, const char* src, size_t src_size)
+{
+#ifdef HUFFMAN_HISTOGRAM_AVX2
+	static const bool avx2 = has_avx2();
+	if(avx2)
+	{
+		count_avx2(frequencies, src, src_size);
+		return;
+	}
+#endif
+
+	count_generic(frequencies, src, src_size);
+}
+
+void count_parallel(byte_frequencies& frequencies, const char* src, size_t src_size, size_t threads)
+{
+	count_parallel(frequencies, src, src_size, threads, std::pmr::get_default_resource());
+}
+
+void count_parallel(byte_frequencies& frequencies, const char* src, size_t src_size, size_t threads, std::pmr::memory_resource* resource)
+{
+	size_t parts = std::min(thread_count(threads), std::max(src_size / min_thread_part_size, size_t{1}));
+	if(parts == 1)
+	{
+		count(frequencies, src, src_size);
+		return;
+	}
+
+	size_t part_size = src_size / parts;
+
+	std::pmr::vector<byte_frequencies> part_frequencies(parts, byte_frequencies{}, resource);
+	parallel_for(parts, parts, [&](size_t part)
+	{
+		size_t begin = part_size * part;
+		size_t end = part + 1 == parts ? src_size : begin + part_size;
+
+		count(part_frequencies[part], src + begin, end - begin);
+	});
+
+	for(const auto& part : part_frequencies)
+	{
+		for(size_t byte = 0; byte < frequencies.size(); byte++)
+		{
+			frequencies[byte] += part[byte];
+		}
+	}
+}
+
+void count_generic(byte_frequencies& frequencies, const char* src, size_t src_size)
+{
+	if(src_size < min_table_size)
+	{
+		count_simple(frequencies, src, src_size);
+		return;
+	}
+
+	SubHistograms<4> tables;
+	while(src_size > 0)
+	{
+		size_t chunk_size = std::min(src_size, SubHistograms<4>::max_chunk_size);
+
+		size_t i = 0;
+		for(; i + 8 <= chunk_size; i += 8)
+		{
+			tables.add(load_le64(src + i));
+		}
+
+		for(; i < chunk_size; i++)
+		{
+			tables.add(i, static_cast<unsigned char>(src[i]), 1);
+		}
+
+		tables.spill(frequencies);
+		src += chunk_size;
+		src_size -= chunk_size;
+	}
+}
+
+#ifdef HUFFMAN_HISTOGRAM_AVX2
+
+bool has_avx2()
+{
+	return __builtin_cpu_supports("avx2");
+}
+
+void count_avx2(byte_frequencies& frequencies, const char* src, size_t src_size)
+{
+	if(src_size < min_table_size)
+	{
+		count_simple(frequencies, src, src_size);
+		return;
+	}
+
+	SubHistograms<8> tables;
+	while(src_size > 0)
+	{
+		size_t chunk_size = std::min(src_size, SubHistograms<8>::max_chunk_size);
+
+		count_avx2_chunk(tables, src, chunk_size);
+
+		tables.spill(frequencies);
+		src += chunk_size;
+		src_size -= chunk_size;
+	}
+}
+
+#endif
+
+} // namespace huffman::histogram
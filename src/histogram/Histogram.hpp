@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define HUFFMAN_HISTOGRAM_AVX2 1
+#endif
+
+namespace huffman::histogram
+{
+
+using byte_frequencies = std::array<size_t, 256>;
+
+/**
+ * @brief						add the number of occurrences of every byte of the source to the frequencies,
+ *								using the fastest kernel the cpu supports
+ * @param[out]	frequencies		frequencies to add to
+ * @param[in]	src				source
+ * @param[in]	src_size		size of the source
+ * @throws						nothing
+ */
+void count(byte_frequencies& frequencies, const char* src, size_t src_size);
+
+/**
+ * @brief						same as count(), splitting the source between threads
+ * @param[in]	threads			number of threads to use (including the calling one), 0 for one per hardware thread
+ * @throws						std::system_error if a thread cannot be started
+ * @note						small sources are counted by fewer threads
+ */
+void count_parallel(byte_frequencies& frequencies, const char* src, size_t src_size, size_t threads);
+
+/**
+ * @brief						same as count_parallel(), with the frequencies of every thread allocated from the resource
+ * @param[in]	resource		memory resource of the frequencies of every thread, not used when a single thread counts
+ * @throws						std::system_error if a thread cannot be started
+ * @throws						std::bad_alloc
+ */
+void count_parallel(byte_frequencies& frequencies, const char* src, size_t src_size, size_t threads, std::pmr::memory_resource* resource);
+
+/**
+ * @brief						same as count(), without any cpu specific instructions
+ * @throws						nothing
+ */
+void count_generic(byte_frequencies& frequencies, const char* src, size_t src_size);
+
+#ifdef HUFFMAN_HISTOGRAM_AVX2
+
+/**
+ * @brief						check if the cpu can run count_avx2()
+ * @throws						nothing
+ */
+bool has_avx2();
+
+/**
+ * @brief						same as count(), using AVX2 instructions
+ * @throws						nothing
+ */
+void count_avx2(byte_frequencies& frequencies, const char* src, size_t src_size);
+
+#endif
+
+} // namespace huffman::histogram
@@ -0,0 +1,103 @@
+#include <huffman/AdaptiveDecoder.hpp>
+#include <huffman/AdaptiveEncoder.hpp>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "TestData.hpp"
+
+using namespace huffman;
+
+namespace
+{
+
+std::string encode(size_t rebuild_period, const std::string& src)
+{
+	AdaptiveEncoder encoder(rebuild_period);
+	std::string dst(src.size() * 4 + 8, 0);
+	auto[src_read, dst_written] = encoder.encode(src.data(), src.size(), dst.data(), dst.size());
+	dst_written += encoder.finish(dst.data() + dst_written, dst.size() - dst_written);
+	dst.resize(dst_written);
+
+	return dst;
+}
+
+} // namespace
+
+TEST(AdaptiveDecoder, decode_chunks)
+{
+	// Text that changes halfway, so the codes change a lot
+	const std::string test_string = make_text(10000) + std::string(3000, 'x') + make_text(5000);
+
+	for(size_t rebuild_period : {10, 100, 4096})
+	{
+		const std::string encoded = encode(rebuild_period, test_string);
+
+		for(size_t chunk_size : {1, 3, 100, 100000})
+		{
+			AdaptiveDecoder decoder(rebuild_period);
+			std::string result(test_string.size(), 0);
+			size_t dst_written = 0;
+
+			for(size_t i = 0; i < encoded.size(); i += chunk_size)
+			{
+				size_t size = std::min(chunk_size, encoded.size() - i);
+				auto[read, written] = decoder.decode(encoded.data() + i, size, result.data() + dst_written, result.size() - dst_written);
+
+				EXPECT_EQ(read, size);
+				dst_written += written;
+			}
+
+			EXPECT_EQ(dst_written, test_string.size());
+			EXPECT_LT(decoder.pending_bits(), 8);
+			EXPECT_EQ(result, test_string) << "rebuild period " << rebuild_period << ", chunk size " << chunk_size;
+		}
+	}
+}
+
+TEST(AdaptiveDecoder, decode_small_destination)
+{
+	const std::string test_string = make_text(1000);
+	const std::string encoded = encode(10, test_string);
+	AdaptiveDecoder decoder(10);
+	std::string result;
+
+	size_t src_read = 0;
+	while(result.size() < test_string.size())
+	{
+		char dst[1];
+		auto[read, written] = decoder.decode(encoded.data() + src_read, encoded.size() - src_read, dst, sizeof(dst));
+
+		ASSERT_EQ(written, 1);
+		EXPECT_LE(decoder.pending_bits(), 64);
+		src_read += read;
+		result.append(dst, written);
+	}
+
+	EXPECT_EQ(result, test_string);
+}
+
+TEST(AdaptiveDecoder, reset_starts_new_stream)
+{
+	const std::string first = make_text(1000);
+	const std::string second(500, 'y');
+	const std::string encoded = encode(100, first) + encode(100, second);
+	AdaptiveDecoder decoder(100);
+	std::string result(first.size(), 0);
+
+	auto[read, written] = decoder.decode(encoded.data(), encoded.size(), result.data(), result.size());
+	EXPECT_EQ(result, first);
+
+	// The padding of the first stream is dropped with the model
+	size_t second_begin = read - decoder.pending_bits() / 8;
+	decoder.reset();
+	result.assign(second.size(), 0);
+	decoder.decode(encoded.data() + second_begin, encoded.size() - second_begin, result.data(), result.size());
+
+	EXPECT_EQ(result, second);
+}
+
+TEST(AdaptiveDecoder, invalid_period)
+{
+	EXPECT_THROW(AdaptiveDecoder(0), std::invalid_argument);
+}
@@ -0,0 +1,91 @@
+#include <huffman/AdaptiveEncoder.hpp>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "TestData.hpp"
+
+using namespace huffman;
+
+namespace
+{
+
+std::string encode_at_once(size_t rebuild_period, const std::string& src)
+{
+	AdaptiveEncoder encoder(rebuild_period);
+	std::string dst(src.size() * 4 + 8, 0);
+	auto[src_read, dst_written] = encoder.encode(src.data(), src.size(), dst.data(), dst.size());
+	dst_written += encoder.finish(dst.data() + dst_written, dst.size() - dst_written);
+	dst.resize(dst_written);
+
+	return dst;
+}
+
+} // namespace
+
+TEST(AdaptiveEncoder, encode_starts_with_8_bit_codes)
+{
+	const std::string test_string = make_text(100);
+
+	// No rebuild yet, every byte takes 8 bits
+	EXPECT_EQ(encode_at_once(1000, test_string).size(), test_string.size());
+}
+
+TEST(AdaptiveEncoder, encode_adapts)
+{
+	const std::string test_string = make_text(100000);
+
+	// 13 distinct bytes take less than 4 bits each once the codes are rebuilt
+	EXPECT_LT(encode_at_once(AdaptiveEncoder::default_rebuild_period, test_string).size(), test_string.size() / 2);
+	EXPECT_LT(encode_at_once(10, test_string.substr(0, 10000)).size(), 10000 / 2);
+}
+
+TEST(AdaptiveEncoder, encode_chunks)
+{
+	const std::string test_string = make_text(10000);
+	const std::string expected = encode_at_once(100, test_string);
+
+	for(size_t chunk_size : {1, 7, 100, 5000})
+	{
+		AdaptiveEncoder encoder(100);
+		std::string result;
+
+		for(size_t i = 0; i < test_string.size(); i += chunk_size)
+		{
+			char dst[8192];
+			auto[src_read, dst_written] = encoder.encode(test_string.data() + i, std::min(chunk_size, test_string.size() - i), dst, sizeof(dst));
+
+			EXPECT_EQ(src_read, std::min(chunk_size, test_string.size() - i));
+			EXPECT_LT(encoder.pending_bits(), 8);
+			result.append(dst, dst_written);
+		}
+
+		char dst[1];
+		result.append(dst, encoder.finish(dst, sizeof(dst)));
+
+		EXPECT_EQ(encoder.pending_bits(), 0);
+		EXPECT_EQ(result, expected) << "chunk size " << chunk_size;
+	}
+}
+
+TEST(AdaptiveEncoder, finish_starts_new_stream)
+{
+	const std::string test_string = make_text(1000);
+	const std::string expected = encode_at_once(100, test_string);
+	AdaptiveEncoder encoder(100);
+
+	for(size_t stream = 0; stream < 2; stream++)
+	{
+		std::string result(expected.size(), 0);
+		auto[src_read, dst_written] = encoder.encode(test_string.data(), test_string.size(), result.data(), result.size());
+		dst_written += encoder.finish(result.data() + dst_written, result.size() - dst_written);
+
+		EXPECT_EQ(dst_written, expected.size());
+		EXPECT_EQ(result, expected) << "stream " << stream;
+	}
+}
+
+TEST(AdaptiveEncoder, invalid_period)
+{
+	EXPECT_THROW(AdaptiveEncoder(0), std::invalid_argument);
+}
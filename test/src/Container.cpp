@@ -0,0 +1,242 @@
+#include <huffman/Container.hpp>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "TestData.hpp"
+
+using namespace huffman;
+
+namespace
+{
+
+std::string compress_string(const std::string& src, size_t block_size)
+{
+	std::string dst(compress_bound(src.size(), block_size), 0);
+	dst.resize(compress(src.data(), src.size(), dst.data(), dst.size(), block_size, 1));
+
+	return dst;
+}
+
+std::string decompress_string(const std::string& src)
+{
+	std::string dst(decompressed_size(src.data(), src.size()), 0);
+	dst.resize(decompress(src.data(), src.size(), dst.data(), dst.size(), 1));
+
+	return dst;
+}
+
+} // namespace
+
+TEST(Container, compress_and_decompress)
+{
+	const std::string test_string = make_text(100000);
+
+	for(size_t block_size : {1, 1000, 4096, 100000, 1000000})
+	{
+		for(size_t threads : {0, 1, 3})
+		{
+			std::string buffer(compress_bound(test_string.size(), block_size), 0);
+			size_t compressed_size = compress(test_string.data(), test_string.size(), buffer.data(), buffer.size(), block_size, threads);
+			ASSERT_NE(compressed_size, 0);
+			EXPECT_EQ(decompressed_size(buffer.data(), compressed_size), test_string.size());
+
+			std::string result(decompressed_size(buffer.data(), compressed_size), 0);
+			EXPECT_EQ(decompress(buffer.data(), compressed_size, result.data(), result.size(), threads), test_string.size());
+			EXPECT_EQ(result, test_string) << "block size " << block_size << ", threads " << threads;
+		}
+	}
+}
+
+TEST(Container, compress_smaller_than_source)
+{
+	const std::string test_string = make_text(100000);
+
+	EXPECT_LT(compress_string(test_string, 4096).size(), test_string.size() / 2);
+}
+
+TEST(Container, compress_empty)
+{
+	const std::string compressed = compress_string("", 10);
+
+	ASSERT_NE(compressed.size(), 0);
+	EXPECT_EQ(decompressed_size(compressed.data(), compressed.size()), 0);
+	EXPECT_EQ(decompress(compressed.data(), compressed.size(), nullptr, 0, 0), 0);
+}
+
+TEST(Container, compress_single_byte)
+{
+	const std::string test_string(1000, 'x');
+	const std::string compressed = compress_string(test_string, 300);
+	std::string result(test_string.size(), 0);
+
+	EXPECT_EQ(decompress(compressed.data(), compressed.size(), result.data(), result.size(), 0), test_string.size());
+	EXPECT_EQ(result, test_string);
+}
+
+TEST(Container, compress_not_enough_space)
+{
+	const std::string test_string = make_text(1000);
+	const std::string compressed = compress_string(test_string, 100);
+	std::string buffer(compressed.size() - 1, 0);
+	std::string result(test_string.size() - 1, 0);
+
+	EXPECT_EQ(compress(test_string.data(), test_string.size(), buffer.data(), buffer.size(), 100, 1), 0);
+	EXPECT_EQ(decompress(compressed.data(), compressed.size(), result.data(), result.size(), 1), 0);
+	EXPECT_THROW(compress(test_string.data(), test_string.size(), buffer.data(), buffer.size(), 0, 1), std::invalid_argument);
+	EXPECT_THROW(static_cast<void>(compress_bound(test_string.size(), max_container_block_size + 1)), std::invalid_argument);
+}
+
+TEST(Container, compress_random)
+{
+	const std::string test_string = make_random(100000);
+	const std::string compressed = compress_string(test_string, 4096);
+
+	// Every block is stored, the header and the block table are all that is added
+	EXPECT_LE(compressed.size(), test_string.size() + 17 + 258 + 25*13 + 4);
+	EXPECT_EQ(decompress_string(compressed), test_string);
+}
+
+TEST(Container, compress_mixed_blocks)
+{
+	// Text, random and repeated blocks, with a dictionary made from all of them
+	const std::string test_string = make_text(4000) + make_random(4000) + std::string(4000, 'x') + make_text(100) + std::string(1000, '\0');
+	const std::string compressed = compress_string(test_string, 1000);
+
+	// Repeated blocks take a single byte
+	EXPECT_LT(compressed.size(), 4000 + 4100);
+	EXPECT_EQ(decompress_string(compressed), test_string);
+
+	ContainerReader reader(compressed.data(), compressed.size());
+	for(size_t block = 0; block < reader.block_count(); block++)
+	{
+		std::string result(reader.decompressed_block_size(block), 0);
+
+		EXPECT_EQ(reader.decompress_block(block, result.data(), result.size()), result.size());
+		EXPECT_EQ(result, test_string.substr(block * 1000, 1000)) << "block " << block;
+	}
+}
+
+TEST(Container, compress_changing_content)
+{
+	// Sections with different bytes, each one bigger than a block
+	std::string test_string;
+	for(size_t i = 0; i < 30000; i++)
+	{
+		test_string += static_cast<char>('a' + (i * i) % 23 % 13);
+	}
+
+	for(size_t i = 0; i < 30000; i++)
+	{
+		test_string += static_cast<char>('0' + (i * i) % 7 % 5);
+	}
+
+	for(size_t i = 0; i < 30000; i++)
+	{
+		test_string += static_cast<char>('A' + i % 26);
+	}
+
+	const std::string compressed = compress_string(test_string, 4096);
+	ContainerReader reader(compressed.data(), compressed.size());
+
+	// Every section gets its own dictionary, which is smaller than a dictionary of all of them
+	HuffmanDictionary global(test_string.data(), test_string.size());
+	EXPECT_GE(reader.dictionary_count(), 3);
+	EXPECT_LT(compressed.size(), global.encoded_bits(test_string.data(), test_string.size()) / 8);
+	EXPECT_EQ(decompress_string(compressed), test_string);
+	EXPECT_THROW(static_cast<void>(reader.dictionary(reader.dictionary_count())), std::out_of_range);
+}
+
+TEST(Container, decompress_invalid_dictionaries)
+{
+	const std::string compressed = compress_string(make_text(3000), 1000);
+	ASSERT_EQ(ContainerReader(compressed.data(), compressed.size()).dictionary_count(), 1);
+
+	// More dictionaries than blocks, or than the bytes left could hold
+	for(uint32_t count : {4u, 0xffffffffu})
+	{
+		std::string modified = compressed;
+		for(size_t i = 0; i < 4; i++)
+		{
+			modified[17 + i] = static_cast<char>(count >> (i*8));
+		}
+
+		EXPECT_THROW(ContainerReader(modified.data(), modified.size()), std::invalid_argument) << "count " << count;
+	}
+
+	// Code lengths that are not a valid dictionary are caught by the header checksum, before they are read
+	std::string modified = compressed;
+	modified[17 + 4 + 2] = '\xff';
+	try
+	{
+		ContainerReader reader(modified.data(), modified.size());
+		ADD_FAILURE() << "invalid dictionary was not rejected";
+	}
+	catch(const std::invalid_argument& error)
+	{
+		EXPECT_STREQ(error.what(), "container header checksum does not match");
+	}
+}
+
+TEST(Container, reader_decompress_block)
+{
+	const std::string test_string = make_text(1050);
+	const std::string compressed = compress_string(test_string, 100);
+	ContainerReader reader(compressed.data(), compressed.size());
+
+	EXPECT_EQ(reader.size(), test_string.size());
+	EXPECT_EQ(reader.block_size(), 100);
+	ASSERT_EQ(reader.block_count(), 11);
+	EXPECT_EQ(reader.decompressed_block_size(10), 50);
+	EXPECT_THROW(static_cast<void>(reader.decompressed_block_size(11)), std::out_of_range);
+
+	// Blocks can be read in any order
+	for(size_t block : {7, 10, 0, 3})
+	{
+		std::string result(reader.decompressed_block_size(block), 0);
+
+		EXPECT_EQ(reader.decompress_block(block, result.data(), result.size()), result.size());
+		EXPECT_EQ(result, test_string.substr(block * 100, 100)) << "block " << block;
+	}
+
+	char byte;
+	EXPECT_EQ(reader.decompress_block(0, &byte, 1), 0);
+}
+
+TEST(Container, decompress_invalid)
+{
+	const std::string test_string = make_text(1000);
+	const std::string compressed = compress_string(test_string, 100);
+	std::string result(test_string.size(), 0);
+
+	auto decompress_modified = [&](const std::string& modified)
+	{
+		decompress(modified.data(), modified.size(), result.data(), result.size(), 1);
+	};
+
+	// Truncated header, block table and blocks
+	for(size_t size : std::initializer_list<size_t>{0, 3, 16, 40, compressed.size() - 1})
+	{
+		EXPECT_THROW(decompress_modified(compressed.substr(0, size)), std::invalid_argument) << "size " << size;
+	}
+
+	std::string modified = compressed;
+	modified[0] = 'X';
+	EXPECT_THROW(decompress_modified(modified), std::invalid_argument);
+
+	// Only the current version is read
+	for(char version : {'\1', '\2', '\4'})
+	{
+		modified = compressed;
+		modified[4] = version;
+		EXPECT_THROW(decompress_modified(modified), std::invalid_argument) << "version " << int{version};
+	}
+
+	// Every changed bit is caught, by the header checksum or by the checksum of its block
+	for(size_t i = 0; i < compressed.size(); i++)
+	{
+		modified = compressed;
+		modified[i] ^= 0x01;
+		EXPECT_THROW(decompress_modified(modified), std::invalid_argument) << "byte " << i;
+	}
+}
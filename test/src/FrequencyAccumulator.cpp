@@ -0,0 +1,106 @@
+#include <huffman/FrequencyAccumulator.hpp>
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace huffman;
+
+namespace
+{
+
+void compare_trees(const HuffmanNode& lhs, const HuffmanNode& rhs)
+{
+	ASSERT_EQ(lhs.is_byte_node(), rhs.is_byte_node());
+
+	if(lhs.is_byte_node())
+	{
+		EXPECT_EQ(lhs.byte(), rhs.byte());
+		EXPECT_EQ(lhs.frequency(), rhs.frequency());
+	}
+	else
+	{
+		compare_trees(*lhs.left(), *rhs.left());
+		compare_trees(*lhs.right(), *rhs.right());
+	}
+}
+
+} // namespace
+
+TEST(FrequencyAccumulator, default_constructor)
+{
+	FrequencyAccumulator accumulator;
+
+	EXPECT_TRUE(accumulator.empty());
+	EXPECT_EQ(accumulator.size(), 0);
+	EXPECT_TRUE(accumulator.dictionary().empty());
+}
+
+TEST(FrequencyAccumulator, add)
+{
+	std::string test_data[] = {"A" "BB" "CCC" "DDDD",  "EEEEE" "FFFFFF" "GGGGGGG", "AAB"};
+	FrequencyAccumulator accumulator;
+
+	for(const auto& chunk : test_data)
+	{
+		accumulator.add(chunk.data(), chunk.size());
+	}
+
+	EXPECT_FALSE(accumulator.empty());
+	EXPECT_EQ(accumulator.size(), 31);
+	EXPECT_EQ(accumulator.frequencies()['A'], 3);
+	EXPECT_EQ(accumulator.frequencies()['B'], 3);
+	EXPECT_EQ(accumulator.frequencies()['G'], 7);
+	EXPECT_EQ(accumulator.frequencies()['H'], 0);
+}
+
+TEST(FrequencyAccumulator, add_accumulator)
+{
+	std::string test_data[] = {"A" "BB" "CCC" "DDDD",  "EEEEE" "FFFFFF" "GGGGGGG"};
+	FrequencyAccumulator accumulators[2];
+	accumulators[0].add(test_data[0].data(), test_data[0].size());
+	accumulators[1].add(test_data[1].data(), test_data[1].size());
+
+	accumulators[0].add(accumulators[1]);
+
+	EXPECT_EQ(accumulators[0].size(), 28);
+	EXPECT_EQ(accumulators[0].frequencies()['A'], 1);
+	EXPECT_EQ(accumulators[0].frequencies()['G'], 7);
+}
+
+TEST(FrequencyAccumulator, clear)
+{
+	std::string test_data = "A" "BB" "CCC";
+	FrequencyAccumulator accumulator;
+	accumulator.add(test_data.data(), test_data.size());
+
+	accumulator.clear();
+
+	EXPECT_TRUE(accumulator.empty());
+	EXPECT_EQ(accumulator.frequencies()['C'], 0);
+}
+
+TEST(FrequencyAccumulator, dictionary)
+{
+	std::string test_data[] = {"A" "BB" "CCC" "DDDD",  "EEEEE" "FFFFFF" "GGGGGGG"};
+	HuffmanDictionary expected(test_data[0].data(), test_data[0].size());
+	expected.create_part(test_data[1].data(), test_data[1].size());
+
+	FrequencyAccumulator accumulator;
+	accumulator.add(test_data[0].data(), test_data[0].size());
+	accumulator.add(test_data[1].data(), test_data[1].size());
+
+	compare_trees(accumulator.dictionary().data(), expected.data());
+}
+
+TEST(FrequencyAccumulator, dictionary_limited)
+{
+	std::string test_data = "A" "BB" "CCC" "DDDD" "EEEEE" "FFFFFF" "GGGGGGG";
+	HuffmanDictionary expected(test_data.data(), test_data.size(), 3);
+
+	FrequencyAccumulator accumulator;
+	accumulator.add(test_data.data(), test_data.size());
+
+	compare_trees(accumulator.dictionary(3).data(), expected.data());
+	EXPECT_THROW(accumulator.dictionary(2), std::invalid_argument);
+	EXPECT_THROW(accumulator.dictionary(HuffmanDictionary::code_length_limit+1), std::invalid_argument);
+}
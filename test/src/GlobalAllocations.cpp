@@ -0,0 +1,88 @@
+#include <huffman/HuffmanDictionary.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "TestData.hpp"
+
+// Replaces the global operator new of the whole executable, so these tests have one of their own
+
+namespace
+{
+
+// Calls of the global operator new
+std::atomic<size_t> global_allocations{0};
+
+} // namespace
+
+void* operator new(size_t size)
+{
+	global_allocations++;
+	if(void* p = std::malloc(std::max<size_t>(size, 1)))
+	{
+		return p;
+	}
+
+	throw std::bad_alloc();
+}
+
+// The memory comes from std::malloc() in operator new above
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+#pragma GCC diagnostic pop
+
+using namespace huffman;
+
+TEST(GlobalAllocations, dictionary_with_memory_resource)
+{
+	const std::string test_string = make_text(10000);
+	std::vector<std::byte> arena(1 << 20);
+	std::pmr::monotonic_buffer_resource buffer(arena.data(), arena.size(), std::pmr::null_memory_resource());
+	std::string result(test_string.size(), 0);
+	std::string encoded(test_string.size(), 0);
+
+	// The tables shared by all empty dictionaries are made once, by the first one
+	HuffmanDictionary warm_up;
+
+	// Counted without the checks in between, they allocate when they fail
+	size_t allocations = global_allocations;
+	bool decoded = true;
+	{
+		HuffmanDictionary dictionary(&buffer);
+
+		for(size_t max_code_length : {0, 8, 0})
+		{
+			dictionary.create(test_string.data(), test_string.size(), max_code_length);
+			auto[bytes_read, bits_written] = dictionary.encode(test_string.data(), test_string.size(), encoded.data(), encoded.size(), 0);
+			dictionary.decode(encoded.data(), (bits_written + 7) / 8, result.data(), result.size(), 0);
+
+			decoded = decoded && result == test_string;
+		}
+
+		HuffmanDictionary copy = dictionary;
+		HuffmanDictionary moved = std::move(copy);
+		decoded = decoded && moved.resource() == &buffer;
+	}
+	allocations = global_allocations - allocations;
+
+	EXPECT_EQ(allocations, 0);
+	EXPECT_TRUE(decoded);
+}
@@ -1,6 +1,16 @@
 #include <huffman/HuffmanDictionary.hpp>
+#include <canonical/CodeLengths.hpp>
 #include <gtest/gtest.h>
 
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "TestData.hpp"
+
 /**
  Useful:
 #include <vector>
@@ -50,6 +60,84 @@ void compare_trees(const HuffmanNode& lhs, const HuffmanNode& rhs)
 	}
 }
 
+/**
+ * @brief				split the buffer into segments of the given sizes, the last one takes the rest
+ */
+template<typename Byte>
+std::vector<std::span<Byte>> split(std::span<Byte> buffer, std::initializer_list<size_t> sizes)
+{
+	std::vector<std::span<Byte>> segments;
+	for(size_t size : sizes)
+	{
+		segments.push_back(buffer.first(size));
+		buffer = buffer.subspan(size);
+	}
+
+	segments.push_back(buffer);
+
+	return segments;
+}
+
+/**
+ * @brief				encode the whole text, starting at bit 0
+ */
+std::string encode_text(const HuffmanDictionary& dictionary, const std::string& text)
+{
+	std::string encoded(dictionary.encode_bound(text.size()), 0);
+	size_t bits = dictionary.encode(text.data(), text.size(), encoded.data(), encoded.size(), 0).second;
+	encoded.resize(bits / 8 + (bits % 8 != 0));
+
+	return encoded;
+}
+
+/**
+ * @brief				decode size bytes, starting at bit 0
+ */
+std::string decode_text(const HuffmanDictionary& dictionary, const std::string& encoded, size_t size)
+{
+	std::string decoded(size, 0);
+	decoded.resize(dictionary.decode(encoded.data(), encoded.size(), decoded.data(), decoded.size(), 0).second);
+
+	return decoded;
+}
+
+/**
+ * Counts the allocations it passes on to its upstream resource
+ */
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+	explicit CountingResource(std::pmr::memory_resource* upstream)
+		: m_upstream{upstream}
+	{
+
+	}
+
+	CountingResource(const CountingResource&) = delete;
+	CountingResource& operator=(const CountingResource&) = delete;
+
+	size_t allocations{0};
+
+private:
+	void* do_allocate(size_t bytes, size_t alignment) override
+	{
+		allocations++;
+		return m_upstream->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void* p, size_t bytes, size_t alignment) override
+	{
+		m_upstream->deallocate(p, bytes, alignment);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+	{
+		return this == &other;
+	}
+
+	std::pmr::memory_resource* m_upstream;
+};
+
 } // namespace
 
 TEST(HuffmanDictionary, decode_tree)
@@ -161,6 +249,145 @@ TEST(HuffmanDictionary, create_from_existing_tree)
 	compare_trees(dictionary.data(), root_node);
 }
 
+TEST(HuffmanDictionary, data_is_built_once)
+{
+	std::string test_data = "A" "BB" "CCC" "DDDD";
+	HuffmanDictionary dictionary(test_data.data(), test_data.size());
+	HuffmanDictionary copy = dictionary;
+
+	const HuffmanNode& root = dictionary.data();
+	EXPECT_EQ(&dictionary.data(), &root);
+	EXPECT_EQ(&copy.data(), &root);
+	EXPECT_EQ(root.frequency(), 10);
+
+	copy.create_part(test_data.data(), test_data.size());
+	EXPECT_EQ(&dictionary.data(), &root);
+	EXPECT_EQ(copy.data().frequency(), 20);
+}
+
+TEST(HuffmanDictionary, move)
+{
+	const std::string test_string = make_text(1000);
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	const std::string encoded = encode_text(dictionary, test_string);
+	const HuffmanNode* root = &dictionary.data();
+
+	HuffmanDictionary moved(std::move(dictionary));
+	EXPECT_EQ(&moved.data(), root);
+	EXPECT_EQ(encode_text(moved, test_string), encoded);
+
+	// The moved-from dictionary is empty, and still usable
+	EXPECT_TRUE(dictionary.empty());
+	EXPECT_EQ(encode_text(dictionary, test_string), "");
+	dictionary.create(test_string.data(), test_string.size());
+	EXPECT_EQ(encode_text(dictionary, test_string), encoded);
+
+	HuffmanDictionary assigned;
+	assigned = std::move(moved);
+	EXPECT_EQ(&assigned.data(), root);
+	EXPECT_EQ(decode_text(assigned, encoded, test_string.size()), test_string);
+	EXPECT_TRUE(moved.empty());
+
+	std::vector<HuffmanDictionary> dictionaries;
+	for(size_t i = 0; i < 16; i++)
+	{
+		dictionaries.emplace_back(test_string.data(), i + 1);
+	}
+
+	EXPECT_EQ(dictionaries.back().size(), 16);
+}
+
+TEST(HuffmanDictionary, copies_share_tables)
+{
+	const std::string test_strings[] = {"A" "BB" "CCC" "DDDD", "EEEEE" "FFFFFF" "G"};
+	HuffmanDictionary dictionary(test_strings[0].data(), test_strings[0].size());
+	const std::string encoded = encode_text(dictionary, test_strings[0]);
+
+	HuffmanDictionary copy = dictionary;
+	EXPECT_EQ(&copy.data(), &dictionary.data());
+	EXPECT_EQ(encode_text(copy, test_strings[0]), encoded);
+
+	// A rebuild only changes the copy that is rebuilt
+	copy.create(test_strings[1].data(), test_strings[1].size());
+	EXPECT_NE(&copy.data(), &dictionary.data());
+	EXPECT_EQ(encode_text(dictionary, test_strings[0]), encoded);
+	EXPECT_EQ(decode_text(dictionary, encoded, test_strings[0].size()), test_strings[0]);
+
+	HuffmanDictionary expected(test_strings[1].data(), test_strings[1].size());
+	EXPECT_EQ(encode_text(copy, test_strings[1]), encode_text(expected, test_strings[1]));
+}
+
+TEST(HuffmanDictionary, rebuild_drops_tables)
+{
+	const std::string test_strings[] = {"A" "BB" "CCC" "DDDD", "EEEEE" "FFFFFF" "G" "A"};
+
+	// Every dictionary is used once first, so that its tables are built
+	auto used = [&](HuffmanDictionary dictionary)
+	{
+		decode_text(dictionary, encode_text(dictionary, test_strings[0]), test_strings[0].size());
+		return dictionary;
+	};
+
+	auto expect_same_codes = [&](const HuffmanDictionary& dictionary, const HuffmanDictionary& expected)
+	{
+		const std::string encoded = encode_text(expected, test_strings[1]);
+		EXPECT_EQ(encode_text(dictionary, test_strings[1]), encoded);
+		EXPECT_EQ(decode_text(dictionary, encoded, test_strings[1].size()), test_strings[1]);
+	};
+
+	HuffmanDictionary created = used(HuffmanDictionary(test_strings[0].data(), test_strings[0].size()));
+	created.create(test_strings[1].data(), test_strings[1].size());
+	expect_same_codes(created, HuffmanDictionary(test_strings[1].data(), test_strings[1].size()));
+
+	HuffmanDictionary part = used(HuffmanDictionary(test_strings[0].data(), test_strings[0].size()));
+	HuffmanDictionary expected_part(test_strings[0].data(), test_strings[0].size());
+	part.create_part(test_strings[1].data(), test_strings[1].size());
+	expected_part.create_part(test_strings[1].data(), test_strings[1].size());
+	expect_same_codes(part, expected_part);
+
+	HuffmanDictionary canonical(test_strings[1].data(), test_strings[1].size(), 8);
+	char serialized[HuffmanDictionary::max_serialized_size];
+	size_t serialized_size = canonical.serialize(serialized, sizeof(serialized));
+	HuffmanDictionary loaded = used(HuffmanDictionary(test_strings[0].data(), test_strings[0].size()));
+	loaded.deserialize(serialized, serialized_size);
+	expect_same_codes(loaded, canonical);
+
+	// 'a' is 1 before and 0 after
+	HuffmanNode root_node{
+		{'a', 7},
+		{ {'b', 3}, {'c', 1} },
+	};
+	HuffmanDictionary reassigned = used(HuffmanDictionary(root_node));
+	HuffmanDictionary expected_reassigned(root_node);
+	reassigned.canonicalize();
+	expected_reassigned.canonicalize();
+	EXPECT_NE(encode_text(reassigned, "a"), encode_text(HuffmanDictionary(root_node), "a"));
+	EXPECT_EQ(encode_text(reassigned, "abc"), encode_text(expected_reassigned, "abc"));
+}
+
+TEST(HuffmanDictionary, create_equal_frequencies)
+{
+	// Newer nodes go before older nodes with the same frequency, merged nodes before bytes
+	HuffmanNode test_trees[] = {
+		{
+			{ { {'f', 1}, {'e', 1} }, { {'h', 1}, {'g', 1} } },
+			{ { {'b', 1}, {'a', 1} }, { {'d', 1}, {'c', 1} } },
+		},
+		{
+			{'a', 2},
+			{ {'b', 1}, { {'d', 1}, {'c', 1} } },
+		},
+	};
+	std::string test_data[] = {"abcdefgh", "aabcd"};
+
+	for(size_t i = 0; i < std::size(test_data); i++)
+	{
+		HuffmanDictionary dictionary(test_data[i].data(), test_data[i].size());
+
+		compare_trees(dictionary.data(), test_trees[i]);
+	}
+}
+
 TEST(HuffmanDictionary, create_empty)
 {
 	HuffmanDictionary dictionary;
@@ -255,6 +482,28 @@ TEST(HuffmanDictionary, encode)
 	EXPECT_EQ(buffer, correctly_encoded_string);
 }
 
+TEST(HuffmanDictionary, encode_resume)
+{
+	const std::string test_string = "A" "BB" "CCC" "DDDD" "EEEEE" "FFFFFF" "GGGGGGG";
+	const std::string correctly_encoded_string =
+	{'\x7F', '\xB7', '\x8D', '\x24', '\x01', '\x00', '\x55', '\xA5', '\xAA', '\x02'};
+	std::string buffer(correctly_encoded_string.size(), 0);
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+
+	size_t offset = 0;
+	for(size_t i = 0; i < test_string.size(); i += 5)
+	{
+		size_t size = std::min<size_t>(5, test_string.size() - i);
+		auto[src_read, bits_written] = dictionary.encode(test_string.data() + i, size, buffer.data(), buffer.size(), offset);
+
+		EXPECT_EQ(src_read, size);
+		offset = bits_written;
+	}
+
+	EXPECT_EQ(offset, (correctly_encoded_string.size()-1)*8+2);
+	EXPECT_EQ(buffer, correctly_encoded_string);
+}
+
 TEST(HuffmanDictionary, encode_and_decode)
 {
 	HuffmanDictionary dictionary;
@@ -269,3 +518,603 @@ TEST(HuffmanDictionary, encode_and_decode)
 
 	EXPECT_EQ(result, test_string);
 }
+
+TEST(HuffmanDictionary, encode_and_decode_span)
+{
+	const std::string test_string = make_text(1000);
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	std::string expected(dictionary.encode_bound(test_string.size()), 0);
+	std::vector<std::byte> buffer(expected.size());
+	std::vector<std::byte> result(test_string.size());
+
+	auto expected_sizes = dictionary.encode(test_string.data(), test_string.size(), expected.data(), expected.size(), 0);
+	auto sizes = dictionary.encode(std::as_bytes(std::span{test_string}), std::span{buffer}, 0);
+	EXPECT_EQ(sizes, expected_sizes);
+	EXPECT_EQ(std::string(reinterpret_cast<const char*>(buffer.data()), buffer.size()), expected);
+
+	sizes = dictionary.decode(std::span<const std::byte>{buffer}, std::span{result}, 0);
+	EXPECT_EQ(sizes, std::make_pair(expected_sizes.second, test_string.size()));
+	EXPECT_EQ(std::string(reinterpret_cast<const char*>(result.data()), result.size()), test_string);
+}
+
+TEST(HuffmanDictionary, encode_and_decode_scatter_gather)
+{
+	const std::string test_string = make_text(1000);
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	std::string expected(dictionary.encode_bound(test_string.size()), 0);
+	auto[bytes_read, bits_written] = dictionary.encode(test_string.data(), test_string.size(), expected.data(), expected.size(), 0);
+	expected.resize((bits_written + 7) / 8);
+
+	// Empty segments, segments shorter than a code and segments long enough for whole words
+	std::vector<std::span<const std::byte>> src = split(std::as_bytes(std::span{test_string}), {0, 1, 3, 0, 500, 7});
+	std::vector<std::byte> buffer(expected.size());
+	std::vector<std::span<std::byte>> dst = split(std::span{buffer}, {1, 0, 2, 100, 3, 1});
+
+	auto sizes = dictionary.encode(src, dst);
+	EXPECT_EQ(sizes, std::make_pair(test_string.size(), bits_written));
+	EXPECT_EQ(std::string(reinterpret_cast<const char*>(buffer.data()), buffer.size()), expected);
+
+	std::vector<std::byte> result(test_string.size());
+	std::vector<std::span<const std::byte>> encoded = split(std::span<const std::byte>{buffer}, {5, 0, 1, 1, 200});
+	std::vector<std::span<std::byte>> decoded = split(std::span{result}, {3, 0, 1, 600});
+
+	sizes = dictionary.decode(encoded, decoded);
+	EXPECT_EQ(sizes, std::make_pair(bits_written, test_string.size()));
+	EXPECT_EQ(std::string(reinterpret_cast<const char*>(result.data()), result.size()), test_string);
+}
+
+TEST(HuffmanDictionary, encode_scatter_gather_not_enough_space)
+{
+	const std::string test_string = make_text(1000);
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	std::string expected(10, 0);
+	auto expected_sizes = dictionary.encode(test_string.data(), test_string.size(), expected.data(), expected.size(), 0);
+
+	// Stops at the last code that fits, like encode()
+	std::vector<std::span<const std::byte>> src = split(std::as_bytes(std::span{test_string}), {10});
+	std::vector<std::byte> buffer(expected.size());
+	std::vector<std::span<std::byte>> dst = split(std::span{buffer}, {3, 3});
+
+	EXPECT_EQ(dictionary.encode(src, dst), expected_sizes);
+	EXPECT_EQ(std::string(reinterpret_cast<const char*>(buffer.data()), buffer.size()), expected);
+	EXPECT_EQ(dictionary.encode(src, {}), std::make_pair(size_t{0}, size_t{0}));
+}
+
+TEST(HuffmanDictionary, encoded_bits)
+{
+	const std::string test_string = "A" "BB" "CCC" "DDDD" "EEEEE" "FFFFFF" "GGGGGGG";
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+
+	for(size_t size : {0, 1, 7, 20, 28})
+	{
+		std::string buffer(dictionary.encode_bound(size), 0);
+		auto[bytes_read, bits_written] = dictionary.encode(test_string.data(), size, buffer.data(), buffer.size(), 0);
+
+		// The bound is always enough, and the number of bits is exact
+		EXPECT_EQ(bytes_read, size);
+		EXPECT_EQ(dictionary.encoded_bits(test_string.data(), size), bits_written) << "size " << size;
+	}
+
+	std::array<size_t, 256> frequencies{};
+	frequencies['A'] = 1;
+	frequencies['G'] = 2;
+	frequencies['Z'] = 100;
+
+	// A has the longest code (4 bits), G one of the shortest (2 bits), Z is not in the dictionary
+	EXPECT_EQ(dictionary.encoded_bits(frequencies), 4 + 2*2);
+	EXPECT_EQ(dictionary.encode_bound(3), 2);
+	EXPECT_EQ(HuffmanDictionary().encode_bound(100), 0);
+}
+
+TEST(HuffmanDictionary, encode_blocks_and_decode_blocks)
+{
+	std::string test_string;
+	for(size_t i = 0; i < 100000; i++)
+	{
+		test_string += static_cast<char>('a' + (i * i) % 23 % 13);
+	}
+
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+
+	for(size_t block_size : {1, 1000, 4096, 100000, 1000000})
+	{
+		for(size_t threads : {0, 1, 3})
+		{
+			std::string buffer(dictionary.encode_blocks_bound(test_string.size(), block_size), 0);
+			std::string result(test_string.size(), 0);
+
+			size_t encoded_size = dictionary.encode_blocks(test_string.data(), test_string.size(), buffer.data(), buffer.size(), block_size, threads);
+			ASSERT_NE(encoded_size, 0);
+			EXPECT_EQ(HuffmanDictionary::decoded_blocks_size(buffer.data(), encoded_size), test_string.size());
+
+			size_t decoded_size = dictionary.decode_blocks(buffer.data(), encoded_size, result.data(), result.size(), threads);
+
+			EXPECT_EQ(decoded_size, test_string.size());
+			EXPECT_EQ(result, test_string) << "block size " << block_size << ", threads " << threads;
+		}
+	}
+}
+
+TEST(HuffmanDictionary, encode_blocks_independent)
+{
+	const std::string test_string = "A" "BB" "CCC" "DDDD" "EEEEE" "FFFFFF" "GGGGGGG";
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	std::string buffer(dictionary.encode_blocks_bound(test_string.size(), 10), 0);
+	std::string result(10, 0);
+
+	size_t encoded_size = dictionary.encode_blocks(test_string.data(), test_string.size(), buffer.data(), buffer.size(), 10, 1);
+
+	// 3 blocks, the second one starts where the first one ends
+	ASSERT_EQ(encoded_size, 16 + 3*8 + static_cast<unsigned char>(buffer[16 + 2*8]));
+	size_t begin = static_cast<unsigned char>(buffer[16]);
+	size_t end = static_cast<unsigned char>(buffer[16 + 8]);
+	auto[bits_read, dst_written] = dictionary.decode(buffer.data() + 16 + 3*8 + begin, end - begin, result.data(), result.size(), 0);
+
+	EXPECT_EQ(dst_written, 10);
+	EXPECT_EQ(result, test_string.substr(10, 10));
+}
+
+TEST(HuffmanDictionary, encode_blocks_empty)
+{
+	HuffmanDictionary dictionary;
+	char buffer[16];
+
+	size_t encoded_size = dictionary.encode_blocks(nullptr, 0, buffer, sizeof(buffer), HuffmanDictionary::default_block_size, 0);
+
+	EXPECT_EQ(encoded_size, 16);
+	EXPECT_EQ(HuffmanDictionary::decoded_blocks_size(buffer, encoded_size), 0);
+	EXPECT_EQ(dictionary.decode_blocks(buffer, encoded_size, nullptr, 0, 0), 0);
+}
+
+TEST(HuffmanDictionary, encode_blocks_not_enough_space)
+{
+	const std::string test_string = "A" "BB" "CCC" "DDDD" "EEEEE" "FFFFFF" "GGGGGGG";
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	std::string buffer(dictionary.encode_blocks_bound(test_string.size(), 10), 0);
+	std::string result(test_string.size() - 1, 0);
+
+	size_t encoded_size = dictionary.encode_blocks(test_string.data(), test_string.size(), buffer.data(), buffer.size(), 10, 1);
+
+	EXPECT_EQ(dictionary.encode_blocks(test_string.data(), test_string.size(), buffer.data(), encoded_size - 1, 10, 1), 0);
+	EXPECT_EQ(dictionary.decode_blocks(buffer.data(), encoded_size, result.data(), result.size(), 1), 0);
+	EXPECT_THROW(dictionary.encode_blocks(test_string.data(), test_string.size(), buffer.data(), buffer.size(), 0, 1), std::invalid_argument);
+	EXPECT_THROW(static_cast<void>(dictionary.encode_blocks_bound(test_string.size(), 0)), std::invalid_argument);
+}
+
+TEST(HuffmanDictionary, decode_blocks_invalid)
+{
+	const std::string test_string = "A" "BB" "CCC" "DDDD" "EEEEE" "FFFFFF" "GGGGGGG";
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	std::string buffer(dictionary.encode_blocks_bound(test_string.size(), 10), 0);
+	std::string result(test_string.size(), 0);
+
+	size_t encoded_size = dictionary.encode_blocks(test_string.data(), test_string.size(), buffer.data(), buffer.size(), 10, 1);
+
+	// Truncated header, index and blocks
+	EXPECT_THROW(HuffmanDictionary::decoded_blocks_size(buffer.data(), 15), std::invalid_argument);
+	EXPECT_THROW(dictionary.decode_blocks(buffer.data(), 16 + 2*8, result.data(), result.size(), 1), std::invalid_argument);
+	EXPECT_THROW(dictionary.decode_blocks(buffer.data(), encoded_size - 1, result.data(), result.size(), 1), std::invalid_argument);
+
+	// Block size 0
+	std::string zero_block_size = buffer;
+	zero_block_size[8] = 0;
+	EXPECT_THROW(dictionary.decode_blocks(zero_block_size.data(), encoded_size, result.data(), result.size(), 1), std::invalid_argument);
+
+	// Block ending before it begins
+	std::string bad_index = buffer;
+	bad_index[16 + 8] = 0;
+	EXPECT_THROW(dictionary.decode_blocks(bad_index.data(), encoded_size, result.data(), result.size(), 1), std::invalid_argument);
+}
+
+TEST(HuffmanDictionary, encode_interleaved_and_decode_interleaved)
+{
+	std::string text;
+	for(size_t i = 0; i < 100001; i++)
+	{
+		text += static_cast<char>('a' + (i * i) % 23 % 13);
+	}
+
+	HuffmanDictionary dictionary(text.data(), text.size());
+
+	for(size_t size : {0, 1, 2, 3, 4, 5, 1000, 100001})
+	{
+		std::string test_string = text.substr(0, size);
+		std::string buffer(dictionary.encode_interleaved_bound(test_string.size()), 0);
+		std::string result(test_string.size(), 0);
+
+		size_t encoded_size = dictionary.encode_interleaved(test_string.data(), test_string.size(), buffer.data(), buffer.size());
+		ASSERT_NE(encoded_size, 0);
+		EXPECT_EQ(HuffmanDictionary::decoded_interleaved_size(buffer.data(), encoded_size), test_string.size());
+
+		size_t decoded_size = dictionary.decode_interleaved(buffer.data(), encoded_size, result.data(), result.size());
+
+		EXPECT_EQ(decoded_size, test_string.size());
+		EXPECT_EQ(result, test_string) << "size " << size;
+	}
+}
+
+TEST(HuffmanDictionary, encode_interleaved_not_enough_space)
+{
+	const std::string test_string = "A" "BB" "CCC" "DDDD" "EEEEE" "FFFFFF" "GGGGGGG";
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	std::string buffer(dictionary.encode_interleaved_bound(test_string.size()), 0);
+	std::string result(test_string.size() - 1, 0);
+
+	size_t encoded_size = dictionary.encode_interleaved(test_string.data(), test_string.size(), buffer.data(), buffer.size());
+
+	EXPECT_EQ(dictionary.encode_interleaved(test_string.data(), test_string.size(), buffer.data(), encoded_size - 1), 0);
+	EXPECT_EQ(dictionary.decode_interleaved(buffer.data(), encoded_size, result.data(), result.size()), 0);
+}
+
+TEST(HuffmanDictionary, decode_interleaved_invalid)
+{
+	const std::string test_string = "A" "BB" "CCC" "DDDD" "EEEEE" "FFFFFF" "GGGGGGG";
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	std::string buffer(dictionary.encode_interleaved_bound(test_string.size()), 0);
+	std::string result(test_string.size(), 0);
+
+	size_t encoded_size = dictionary.encode_interleaved(test_string.data(), test_string.size(), buffer.data(), buffer.size());
+
+	// Truncated header and last stream
+	EXPECT_THROW(HuffmanDictionary::decoded_interleaved_size(buffer.data(), 31), std::invalid_argument);
+	EXPECT_THROW(dictionary.decode_interleaved(buffer.data(), encoded_size - 1, result.data(), result.size()), std::invalid_argument);
+
+	// Stream longer than the source
+	std::string bad_header = buffer;
+	bad_header[8] = 100;
+	EXPECT_THROW(dictionary.decode_interleaved(bad_header.data(), encoded_size, result.data(), result.size()), std::invalid_argument);
+}
+
+TEST(HuffmanDictionary, encode_batch_and_decode_batch)
+{
+	std::string text;
+	for(size_t i = 0; i < 100000; i++)
+	{
+		text += static_cast<char>('a' + (i * i) % 23 % 13);
+	}
+
+	HuffmanDictionary dictionary(text.data(), text.size());
+
+	// Messages of every length from 0 to 99, some empty, more than a group of every thread
+	std::vector<HuffmanDictionary::Message> messages;
+	std::vector<size_t> decoded_sizes;
+	for(size_t begin = 0, size = 0; begin + size <= text.size(); begin += size, size = (size + 37) % 100)
+	{
+		messages.push_back({text.data() + begin, size});
+		decoded_sizes.push_back(size);
+	}
+
+	for(size_t threads : {0, 1, 3})
+	{
+		std::string buffer(dictionary.encode_batch_bound(messages.data(), messages.size()), 0);
+		std::vector<size_t> encoded_sizes(messages.size());
+
+		size_t encoded_size = dictionary.encode_batch(messages.data(), messages.size(), buffer.data(), buffer.size(), encoded_sizes.data(), threads);
+		ASSERT_NE(encoded_size, 0);
+
+		// Every message is encoded like on its own, right after the previous one
+		std::vector<HuffmanDictionary::Message> encoded;
+		size_t begin = 0;
+		for(size_t i = 0; i < messages.size(); i++)
+		{
+			std::string alone(messages[i].size * 2, 0);
+			auto[bytes_read, bits_written] = dictionary.encode(messages[i].data, messages[i].size, alone.data(), alone.size(), 0);
+			ASSERT_EQ(encoded_sizes[i], (bits_written + 7) / 8);
+			ASSERT_EQ(buffer.substr(begin, encoded_sizes[i]), alone.substr(0, encoded_sizes[i])) << "message " << i;
+
+			encoded.push_back({buffer.data() + begin, encoded_sizes[i]});
+			begin += encoded_sizes[i];
+		}
+
+		EXPECT_EQ(begin, encoded_size);
+
+		std::string result(text.size(), 0);
+		size_t decoded_size = dictionary.decode_batch(encoded.data(), encoded.size(), result.data(), result.size(), decoded_sizes.data(), threads);
+
+		ASSERT_EQ(decoded_size, static_cast<size_t>(messages.back().data + messages.back().size - text.data()));
+		EXPECT_EQ(result.substr(0, decoded_size), text.substr(0, decoded_size)) << "threads " << threads;
+	}
+}
+
+TEST(HuffmanDictionary, encode_batch_empty)
+{
+	HuffmanDictionary dictionary("ab", 2);
+
+	EXPECT_EQ(dictionary.encode_batch_bound(nullptr, 0), 0);
+	EXPECT_EQ(dictionary.encode_batch(nullptr, 0, nullptr, 0, nullptr, 0), 0);
+	EXPECT_EQ(dictionary.decode_batch(nullptr, 0, nullptr, 0, nullptr, 0), 0);
+}
+
+TEST(HuffmanDictionary, encode_batch_not_enough_space)
+{
+	const std::string test_string = "A" "BB" "CCC" "DDDD" "EEEEE" "FFFFFF" "GGGGGGG";
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	const std::array<HuffmanDictionary::Message, 2> messages{{{test_string.data(), 10}, {test_string.data() + 10, 18}}};
+	std::string buffer(dictionary.encode_batch_bound(messages.data(), messages.size()), 0);
+	std::array<size_t, 2> sizes{};
+
+	size_t encoded_size = dictionary.encode_batch(messages.data(), messages.size(), buffer.data(), buffer.size(), sizes.data(), 1);
+	ASSERT_NE(encoded_size, 0);
+
+	EXPECT_EQ(dictionary.encode_batch(messages.data(), messages.size(), buffer.data(), encoded_size - 1, sizes.data(), 1), 0);
+
+	const std::array<HuffmanDictionary::Message, 2> encoded{{{buffer.data(), sizes[0]}, {buffer.data() + sizes[0], sizes[1]}}};
+	const std::array<size_t, 2> decoded_sizes{10, 18};
+	std::string result(test_string.size(), 0);
+
+	EXPECT_EQ(dictionary.decode_batch(encoded.data(), encoded.size(), result.data(), result.size() - 1, decoded_sizes.data(), 1), 0);
+	EXPECT_EQ(dictionary.decode_batch(encoded.data(), encoded.size(), result.data(), result.size(), decoded_sizes.data(), 1), test_string.size());
+	EXPECT_EQ(result, test_string);
+}
+
+TEST(HuffmanDictionary, decode_batch_truncated)
+{
+	const std::string test_string = "A" "BB" "CCC" "DDDD" "EEEEE" "FFFFFF" "GGGGGGG";
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	const HuffmanDictionary::Message message{test_string.data(), test_string.size()};
+	std::string buffer(dictionary.encode_batch_bound(&message, 1), 0);
+	size_t encoded_size = 0;
+	dictionary.encode_batch(&message, 1, buffer.data(), buffer.size(), &encoded_size, 1);
+
+	const HuffmanDictionary::Message truncated{buffer.data(), encoded_size - 1};
+	std::string result(test_string.size(), 0);
+	size_t decoded_size = test_string.size();
+
+	EXPECT_THROW(dictionary.decode_batch(&truncated, 1, result.data(), result.size(), &decoded_size, 1), std::invalid_argument);
+}
+
+TEST(HuffmanDictionary, memory_resource)
+{
+	const std::string test_string = make_text(10000);
+	std::vector<std::byte> arena(1 << 20);
+	std::pmr::monotonic_buffer_resource buffer(arena.data(), arena.size(), std::pmr::null_memory_resource());
+	CountingResource counting(&buffer);
+
+	// Nothing may come from the default resource while the dictionary is rebuilt and used
+	std::pmr::memory_resource* default_resource = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+	std::string result(test_string.size(), 0);
+	std::string encoded(test_string.size(), 0);
+	{
+		HuffmanDictionary dictionary(&counting);
+		EXPECT_EQ(dictionary.resource(), &counting);
+
+		for(size_t max_code_length : {0, 8, 0})
+		{
+			dictionary.create(test_string.data(), test_string.size(), max_code_length);
+			auto[bytes_read, bits_written] = dictionary.encode(test_string.data(), test_string.size(), encoded.data(), encoded.size(), 0);
+			dictionary.decode(encoded.data(), (bits_written + 7) / 8, result.data(), result.size(), 0);
+
+			EXPECT_EQ(result, test_string);
+		}
+
+		HuffmanDictionary copy = dictionary;
+		EXPECT_EQ(copy.resource(), &counting);
+	}
+	std::pmr::set_default_resource(default_resource);
+
+	EXPECT_GT(counting.allocations, 0);
+}
+
+TEST(HuffmanDictionary, create_limited)
+{
+	// Fibonacci frequencies make the deepest possible tree
+	std::string test_string;
+	size_t a = 1, b = 1;
+	for(char c = 'a'; c <= 'z'; c++)
+	{
+		test_string.append(a, c);
+		b = a + b;
+		a = b - a;
+	}
+
+	HuffmanDictionary unlimited(test_string.data(), test_string.size());
+	HuffmanDictionary dictionary(test_string.data(), test_string.size(), 12);
+	std::string buffer(test_string.size(), 0);
+	std::string result(test_string.size(), 0);
+
+	auto[src_read, bits_written] = dictionary.encode(test_string.data(), test_string.size(), buffer.data(), buffer.size(), 0);
+	auto[bits_read, dst_written] = dictionary.decode(buffer.data(), buffer.size(), result.data(), result.size(), 0);
+
+	EXPECT_EQ(canonical::tree_depth(unlimited.tree()), 25);
+	EXPECT_EQ(canonical::tree_depth(dictionary.tree()), 12);
+	EXPECT_EQ(dictionary.size(), test_string.size());
+	EXPECT_EQ(src_read, test_string.size());
+	EXPECT_EQ(bits_read, bits_written);
+	EXPECT_EQ(result, test_string);
+}
+
+TEST(HuffmanDictionary, create_threads)
+{
+	std::string test_string;
+	for(size_t i = 0; i < 1000000; i++)
+	{
+		test_string += static_cast<char>((i * i) % 251 ^ i % 7);
+	}
+
+	for(size_t max_code_length : {0, 9})
+	{
+		HuffmanDictionary expected(test_string.data(), test_string.size(), max_code_length);
+
+		for(size_t threads : {0, 1, 2, 5})
+		{
+			HuffmanDictionary dictionary;
+			dictionary.create(test_string.data(), test_string.size(), max_code_length, threads);
+
+			EXPECT_EQ(dictionary.size(), test_string.size());
+			compare_trees(dictionary.data(), expected.data());
+		}
+	}
+}
+
+TEST(HuffmanDictionary, create_limited_part)
+{
+	std::string test_data[] = {"A" "BB" "CCC" "DDDD",  "EEEEE" "FFFFFF" "GGGGGGG"};
+	HuffmanDictionary dictionary(test_data[0].data(), test_data[0].size(), 3);
+
+	dictionary.create_part(test_data[1].data(), test_data[1].size());
+
+	EXPECT_EQ(dictionary.size(), 28);
+	EXPECT_EQ(canonical::tree_depth(dictionary.tree()), 3);
+}
+
+TEST(HuffmanDictionary, create_limited_invalid)
+{
+	std::string test_string = "A" "BB" "CCC" "DDDD" "EEEEE";
+	HuffmanDictionary dictionary;
+
+	EXPECT_THROW(dictionary.create(test_string.data(), test_string.size(), 2), std::invalid_argument);
+	EXPECT_THROW(dictionary.create(test_string.data(), test_string.size(), HuffmanDictionary::code_length_limit+1), std::invalid_argument);
+}
+
+TEST(HuffmanDictionary, create_from_deep_tree)
+{
+	HuffmanNode root{'a', 1};
+	for(size_t i = 0; i <= HuffmanDictionary::code_length_limit; i++)
+	{
+		root = HuffmanNode{HuffmanNode{'b', 1}, std::move(root)};
+	}
+
+	EXPECT_THROW(HuffmanDictionary{root}, std::length_error);
+}
+
+TEST(HuffmanDictionary, serialize)
+{
+	const std::string test_string = "A" "BB" "CCC" "DDDD" "EEEEE" "FFFFFF" "GGGGGGG";
+	HuffmanDictionary dictionary(test_string.data(), test_string.size(), 12);
+	char serialized[HuffmanDictionary::max_serialized_size];
+
+	size_t serialized_size = dictionary.serialize(serialized, sizeof(serialized));
+
+	HuffmanDictionary loaded;
+	EXPECT_EQ(loaded.deserialize(serialized, serialized_size), serialized_size);
+	EXPECT_EQ(serialized_size, 2 + 128);
+
+	std::string buffer(test_string.size(), 0);
+	std::string result(test_string.size(), 0);
+	auto[src_read, bits_written] = dictionary.encode(test_string.data(), test_string.size(), buffer.data(), buffer.size(), 0);
+	auto[bits_read, dst_written] = loaded.decode(buffer.data(), buffer.size(), result.data(), result.size(), 0);
+
+	EXPECT_EQ(bits_read, bits_written);
+	EXPECT_EQ(result, test_string);
+	EXPECT_EQ(canonical::tree_code_lengths(loaded.tree()), canonical::tree_code_lengths(dictionary.tree()));
+}
+
+TEST(HuffmanDictionary, serialize_long_codes)
+{
+	std::string test_string;
+	size_t a = 1, b = 1;
+	for(char c = 'a'; c <= 'u'; c++)
+	{
+		test_string.append(a, c);
+		b = a + b;
+		a = b - a;
+	}
+
+	HuffmanDictionary dictionary(test_string.data(), test_string.size(), 20);
+	char serialized[HuffmanDictionary::max_serialized_size];
+
+	size_t serialized_size = dictionary.serialize(serialized, sizeof(serialized));
+
+	HuffmanDictionary loaded;
+	loaded.deserialize(serialized, serialized_size);
+
+	EXPECT_EQ(serialized_size, 2 + 256);
+	EXPECT_EQ(canonical::tree_code_lengths(loaded.tree()), canonical::tree_code_lengths(dictionary.tree()));
+	EXPECT_EQ(loaded.size(), 1 << 20);
+}
+
+TEST(HuffmanDictionary, serialize_single_byte)
+{
+	const std::string test_string = "xxxx";
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	char serialized[HuffmanDictionary::max_serialized_size];
+
+	size_t serialized_size = dictionary.serialize(serialized, sizeof(serialized));
+
+	HuffmanDictionary loaded;
+	loaded.deserialize(serialized, serialized_size);
+
+	EXPECT_EQ(serialized_size, 3);
+	EXPECT_TRUE(loaded.data().is_byte_node());
+	EXPECT_EQ(loaded.data().byte(), 'x');
+	EXPECT_FALSE(loaded.empty());
+}
+
+TEST(HuffmanDictionary, serialize_empty)
+{
+	HuffmanDictionary dictionary;
+	char serialized[HuffmanDictionary::max_serialized_size];
+
+	size_t serialized_size = dictionary.serialize(serialized, sizeof(serialized));
+
+	HuffmanDictionary loaded("abc", 3);
+	loaded.deserialize(serialized, serialized_size);
+
+	EXPECT_EQ(serialized_size, 2);
+	EXPECT_TRUE(loaded.empty());
+}
+
+TEST(HuffmanDictionary, serialize_not_canonical)
+{
+	HuffmanNode root_node{
+		{'a', 7},
+		{
+			{'b', 3}, {'c', 1}
+		}
+	};
+
+	HuffmanDictionary dictionary(root_node);
+	char serialized[HuffmanDictionary::max_serialized_size];
+
+	EXPECT_THROW(dictionary.serialize(serialized, sizeof(serialized)), std::logic_error);
+
+	dictionary.canonicalize();
+
+	EXPECT_EQ(dictionary.serialize(serialized, 1), 0);
+	EXPECT_GT(dictionary.serialize(serialized, sizeof(serialized)), 0);
+	EXPECT_EQ(dictionary.size(), 11);
+}
+
+TEST(HuffmanDictionary, deserialize_keeps_max_code_length)
+{
+	const std::string test_string = "A" "BB" "CCC" "DDDD";
+	HuffmanDictionary dictionary(test_string.data(), test_string.size(), 8);
+	char serialized[HuffmanDictionary::max_serialized_size];
+	size_t serialized_size = dictionary.serialize(serialized, sizeof(serialized));
+
+	std::string all_bytes(256, 0);
+	for(size_t i = 0; i < all_bytes.size(); i++)
+	{
+		all_bytes[i] = static_cast<char>(i);
+	}
+
+	// The longest code is 3 bits long, which is no limit for the new data
+	HuffmanDictionary loaded;
+	loaded.deserialize(serialized, serialized_size);
+	EXPECT_NO_THROW(loaded.create_part(all_bytes.data(), all_bytes.size()));
+	EXPECT_EQ(loaded.size(), 8 + 256);
+
+	// The limit of the dictionary is kept
+	HuffmanDictionary limited(test_string.data(), test_string.size(), 4);
+	limited.deserialize(serialized, serialized_size);
+	EXPECT_THROW(limited.create_part(all_bytes.data(), all_bytes.size()), std::invalid_argument);
+}
+
+TEST(HuffmanDictionary, deserialize_invalid)
+{
+	const std::string test_string = "A" "BB" "CCC" "DDDD";
+	HuffmanDictionary dictionary(test_string.data(), test_string.size(), 8);
+	char serialized[HuffmanDictionary::max_serialized_size];
+	size_t serialized_size = dictionary.serialize(serialized, sizeof(serialized));
+
+	HuffmanDictionary loaded;
+
+	EXPECT_THROW(loaded.deserialize(serialized, serialized_size-1), std::invalid_argument);
+	EXPECT_THROW(loaded.deserialize(nullptr, 0), std::invalid_argument);
+
+	serialized[2 + 'A'/2] = '\x11';
+	EXPECT_THROW(loaded.deserialize(serialized, serialized_size), std::invalid_argument);
+
+	serialized[0] = '\x7F';
+	EXPECT_THROW(loaded.deserialize(serialized, serialized_size), std::invalid_argument);
+}
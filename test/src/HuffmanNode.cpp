@@ -100,4 +100,33 @@ TEST(HuffmanNode, tree_node)
 	EXPECT_EQ(node.frequency(), 12);
 	EXPECT_EQ(node.left()->frequency(), 7);
 	EXPECT_EQ(node.right()->frequency(), 5);
-}
\ No newline at end of file
+}
+
+TEST(HuffmanNode, copy_assignment_byte_node_over_tree)
+{
+	HuffmanNode node{
+		{'a', 1},
+		{'b', 2}
+	};
+
+	HuffmanNode byte_node{'x', 7};
+
+	node = byte_node;
+
+	EXPECT_TRUE(node.is_byte_node());
+	EXPECT_EQ(node.left(), nullptr);
+	EXPECT_EQ(node.right(), nullptr);
+}
+
+TEST(HuffmanNode, copy_assignment_self)
+{
+	HuffmanNode node{
+		{'a', 1},
+		{'b', 2}
+	};
+	const HuffmanNode& same = node;
+
+	node = same;
+
+	compare_trees(node, HuffmanNode{{'a', 1}, {'b', 2}});
+}
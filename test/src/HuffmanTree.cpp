@@ -0,0 +1,93 @@
+#include <huffman/HuffmanTree.hpp>
+#include <gtest/gtest.h>
+
+using namespace huffman;
+
+TEST(HuffmanTree, default_constructor)
+{
+	HuffmanTree tree;
+
+	EXPECT_EQ(tree.node_count(), 1);
+	EXPECT_TRUE(tree.is_byte_node(tree.root()));
+	EXPECT_EQ(tree.byte(tree.root()), 0);
+	EXPECT_EQ(tree.frequency(tree.root()), 0);
+}
+
+TEST(HuffmanTree, add_nodes)
+{
+	HuffmanTree tree;
+	tree.clear();
+
+	auto a = tree.add_byte_node('a', 7);
+	auto b = tree.add_byte_node('b', 3);
+	auto root = tree.add_node(a, b);
+
+	EXPECT_EQ(tree.node_count(), 3);
+	EXPECT_EQ(tree.root(), root);
+	EXPECT_FALSE(tree.is_byte_node(root));
+	EXPECT_EQ(tree.frequency(root), 10);
+	EXPECT_EQ(tree.byte(tree.left(root)), 'a');
+	EXPECT_EQ(tree.byte(tree.right(root)), 'b');
+}
+
+TEST(HuffmanTree, too_many_nodes)
+{
+	HuffmanTree tree;
+	tree.clear();
+
+	for(size_t i = 0; i < HuffmanTree::max_nodes; i++)
+	{
+		tree.add_byte_node('x', 1);
+	}
+
+	EXPECT_THROW(tree.add_byte_node('x', 1), std::length_error);
+}
+
+TEST(HuffmanTree, from_node)
+{
+	HuffmanNode root_node{
+		{'a', 7},
+		{
+			{'\xFF', 3}, {'c', 1}
+		}
+	};
+
+	HuffmanTree tree(root_node);
+	auto root = tree.root();
+
+	EXPECT_EQ(tree.node_count(), 5);
+	EXPECT_EQ(tree.frequency(root), 11);
+	EXPECT_EQ(tree.byte(tree.left(root)), 'a');
+	EXPECT_EQ(tree.byte(tree.left(tree.right(root))), '\xFF');
+	EXPECT_EQ(tree.frequency(tree.right(tree.right(root))), 1);
+}
+
+TEST(HuffmanTree, to_node)
+{
+	HuffmanNode root_node{
+		{'a', 7},
+		{
+			{'b', 3}, {'c', 1}
+		}
+	};
+
+	HuffmanTree tree(root_node);
+	HuffmanNode copy = tree.node(tree.root());
+
+	EXPECT_EQ(copy.frequency(), 11);
+	EXPECT_EQ(copy.left()->byte(), 'a');
+	EXPECT_EQ(copy.right()->left()->byte(), 'b');
+	EXPECT_EQ(copy.right()->right()->byte(), 'c');
+}
+
+TEST(HuffmanTree, copy)
+{
+	HuffmanTree tree(HuffmanNode{{'a', 1}, {'b', 2}});
+	HuffmanTree copy;
+
+	copy = tree;
+
+	EXPECT_EQ(copy.node_count(), 3);
+	EXPECT_EQ(copy.frequency(copy.root()), 3);
+	EXPECT_EQ(copy.byte(copy.right(copy.root())), 'b');
+}
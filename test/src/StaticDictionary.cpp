@@ -0,0 +1,140 @@
+#include <huffman/StaticDictionary.hpp>
+#include <canonical/CodeLengths.hpp>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "TestData.hpp"
+
+using namespace huffman;
+
+namespace
+{
+
+// Canonical codes in the order of (length, byte): 'a' -> 0, 'b' -> 10, 'c' -> 110, 'd' -> 111 (first bit on the left)
+constexpr std::array<uint8_t, 256> abcd_lengths = []
+{
+	std::array<uint8_t, 256> lengths{};
+	lengths['a'] = 1;
+	lengths['b'] = 2;
+	lengths['c'] = 3;
+	lengths['d'] = 3;
+
+	return lengths;
+}();
+
+constexpr std::array<char, 2> encode_at_compile_time()
+{
+	std::array<char, 2> dst{};
+	static_dictionary<abcd_lengths>.encode("abcd", 4, dst.data(), dst.size());
+
+	return dst;
+}
+
+constexpr std::array<char, 4> decode_at_compile_time()
+{
+	std::array<char, 2> src = encode_at_compile_time();
+	std::array<char, 4> dst{};
+	static_dictionary<abcd_lengths>.decode(src.data(), src.size(), dst.data(), dst.size());
+
+	return dst;
+}
+
+// The first bit of the stream is the least significant bit of the first byte
+static_assert(encode_at_compile_time()[0] == static_cast<char>(0b11011010));
+static_assert(encode_at_compile_time()[1] == 0b1);
+static_assert(decode_at_compile_time() == std::array<char, 4>{'a', 'b', 'c', 'd'});
+
+} // namespace
+
+TEST(StaticDictionary, encode_and_decode)
+{
+	const std::string test_string = "abacabadabacaba";
+	std::string encoded(8, 0);
+	std::string result(test_string.size(), 0);
+
+	auto[src_read, bits_written] = static_dictionary<abcd_lengths>.encode(test_string.data(), test_string.size(), encoded.data(), encoded.size());
+	auto[bits_read, dst_written] = static_dictionary<abcd_lengths>.decode(encoded.data(), encoded.size(), result.data(), result.size());
+
+	EXPECT_EQ(src_read, test_string.size());
+	EXPECT_EQ(bits_written, 8*1 + 4*2 + 3*3);
+	EXPECT_EQ(bits_read, bits_written);
+	EXPECT_EQ(dst_written, test_string.size());
+	EXPECT_EQ(result, test_string);
+}
+
+TEST(StaticDictionary, same_codes_as_canonical_dictionary)
+{
+	// Fibonacci frequencies make codes longer than root_bits, which are decoded bit by bit
+	std::string test_string = make_text(5000);
+	for(size_t i = 0, previous = 1, frequency = 1; i < 20; i++, std::tie(previous, frequency) = std::pair(frequency, previous + frequency))
+	{
+		test_string += std::string(frequency, static_cast<char>('A' + i));
+	}
+
+	for(size_t max_code_length : {6, 8, 12, 32})
+	{
+		HuffmanDictionary dictionary;
+		dictionary.create(test_string.data(), test_string.size(), max_code_length);
+		StaticDictionary static_dictionary(canonical::tree_code_lengths(dictionary.tree()));
+
+		std::string expected(test_string.size() * 4, 0);
+		std::string encoded(test_string.size() * 4, 0);
+		auto[expected_read, expected_bits] = dictionary.encode(test_string.data(), test_string.size(), expected.data(), expected.size(), 0);
+		auto[src_read, bits_written] = static_dictionary.encode(test_string.data(), test_string.size(), encoded.data(), encoded.size());
+		encoded.resize((bits_written + 7) / 8);
+		expected.resize((expected_bits + 7) / 8);
+
+		EXPECT_EQ(bits_written, expected_bits);
+		EXPECT_EQ(bits_written, static_dictionary.encoded_bits(test_string.data(), test_string.size()));
+		EXPECT_EQ(encoded, expected) << "max code length " << max_code_length;
+
+		std::string result(test_string.size(), 0);
+		auto[bits_read, dst_written] = static_dictionary.decode(encoded.data(), encoded.size(), result.data(), result.size());
+
+		EXPECT_EQ(bits_read, bits_written);
+		EXPECT_EQ(result, test_string) << "max code length " << max_code_length;
+	}
+}
+
+TEST(StaticDictionary, encode_not_enough_space)
+{
+	const std::string test_string = "dddd";
+	std::string encoded(1, 0);
+
+	auto[src_read, bits_written] = static_dictionary<abcd_lengths>.encode(test_string.data(), test_string.size(), encoded.data(), encoded.size());
+
+	EXPECT_EQ(src_read, 2);
+	EXPECT_EQ(bits_written, 6);
+}
+
+TEST(StaticDictionary, decode_truncated)
+{
+	// Six times 'a', then the first two bits of 'c' or 'd'
+	const std::string encoded(1, static_cast<char>(0b11000000));
+	std::string result(8, 0);
+
+	auto[bits_read, dst_written] = static_dictionary<abcd_lengths>.decode(encoded.data(), encoded.size(), result.data(), result.size());
+
+	EXPECT_EQ(dst_written, 6);
+	EXPECT_EQ(bits_read, 6);
+	EXPECT_EQ(result.substr(0, 6), "aaaaaa");
+}
+
+TEST(StaticDictionary, invalid)
+{
+	std::array<uint8_t, 256> lengths{};
+	EXPECT_THROW(StaticDictionary{lengths}, std::invalid_argument);
+
+	lengths['a'] = 1;
+	EXPECT_THROW(StaticDictionary{lengths}, std::invalid_argument);
+
+	lengths['b'] = 2;
+	lengths['c'] = 2;
+	EXPECT_NO_THROW(StaticDictionary{lengths});
+
+	lengths['d'] = 2;
+	EXPECT_THROW(StaticDictionary{lengths}, std::invalid_argument);
+
+	EXPECT_THROW(static_cast<void>(static_dictionary<abcd_lengths>.encoded_bits("e", 1)), std::invalid_argument);
+}
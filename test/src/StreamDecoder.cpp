@@ -0,0 +1,129 @@
+#include <huffman/StreamDecoder.hpp>
+#include <huffman/StreamEncoder.hpp>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "TestData.hpp"
+
+using namespace huffman;
+
+namespace
+{
+
+std::string encode(HuffmanDictionary& dictionary, const std::string& src)
+{
+	std::string dst(src.size() * 4, 0);
+	auto[src_read, bits_written] = dictionary.encode(src.data(), src.size(), dst.data(), dst.size(), 0);
+	dst.resize((bits_written + 7) / 8);
+
+	return dst;
+}
+
+} // namespace
+
+TEST(StreamDecoder, decode_chunks)
+{
+	const std::string test_string = make_text(1000);
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	const std::string encoded = encode(dictionary, test_string);
+
+	for(size_t chunk_size : {1, 3, 8, 100})
+	{
+		StreamDecoder decoder(dictionary);
+		std::string result(test_string.size(), 0);
+		size_t dst_written = 0;
+
+		for(size_t i = 0; i < encoded.size(); i += chunk_size)
+		{
+			size_t size = std::min(chunk_size, encoded.size() - i);
+			auto[read, written] = decoder.decode(encoded.data() + i, size, result.data() + dst_written, result.size() - dst_written);
+
+			EXPECT_EQ(read, size);
+			dst_written += written;
+		}
+
+		EXPECT_EQ(dst_written, test_string.size());
+		EXPECT_LT(decoder.pending_bits(), 8);
+		EXPECT_EQ(result, test_string) << "chunk size " << chunk_size;
+	}
+}
+
+TEST(StreamDecoder, decode_small_destination)
+{
+	const std::string test_string = make_text(100);
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	const std::string encoded = encode(dictionary, test_string);
+	StreamDecoder decoder(dictionary);
+	std::string result;
+
+	size_t src_read = 0;
+	while(result.size() < test_string.size())
+	{
+		char dst[1];
+		auto[read, written] = decoder.decode(encoded.data() + src_read, encoded.size() - src_read, dst, sizeof(dst));
+
+		ASSERT_EQ(written, 1);
+		EXPECT_LE(decoder.pending_bits(), 64);
+		src_read += read;
+		result.append(dst, written);
+	}
+
+	EXPECT_EQ(src_read, encoded.size());
+	EXPECT_EQ(result, test_string);
+}
+
+TEST(StreamDecoder, reset)
+{
+	const std::string test_string = "A" "BB" "CCC" "DDDD" "EEEEE" "FFFFFF" "GGGGGGG";
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	const std::string encoded = encode(dictionary, test_string);
+	StreamDecoder decoder(dictionary);
+	std::string result(test_string.size(), 0);
+
+	decoder.decode(encoded.data(), 1, result.data(), result.size());
+	decoder.reset();
+
+	EXPECT_EQ(decoder.pending_bits(), 0);
+
+	auto[read, written] = decoder.decode(encoded.data(), encoded.size(), result.data(), result.size());
+
+	EXPECT_EQ(read, encoded.size());
+	EXPECT_EQ(written, test_string.size());
+	EXPECT_EQ(result, test_string);
+}
+
+TEST(StreamDecoder, stream_encoder)
+{
+	const std::string test_string = make_text(5000);
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	StreamEncoder encoder(dictionary);
+	StreamDecoder decoder(dictionary);
+	std::string result;
+
+	// Small buffers on both sides, like a socket
+	for(size_t i = 0; i < test_string.size(); i += 7)
+	{
+		char encoded[3];
+		size_t src_size = std::min<size_t>(7, test_string.size() - i);
+		for(size_t src_read = 0; src_read < src_size || encoder.pending_bits() >= 8;)
+		{
+			auto[read, encoded_size] = encoder.encode(test_string.data() + i + src_read, src_size - src_read, encoded, sizeof(encoded));
+			src_read += read;
+
+			char decoded[64];
+			auto[decoder_read, decoded_size] = decoder.decode(encoded, encoded_size, decoded, sizeof(decoded));
+
+			EXPECT_EQ(decoder_read, encoded_size);
+			result.append(decoded, decoded_size);
+		}
+	}
+
+	char encoded[8];
+	size_t encoded_size = encoder.finish(encoded, sizeof(encoded));
+	std::string rest(test_string.size() - result.size(), 0);
+	auto[decoder_read, decoded_size] = decoder.decode(encoded, encoded_size, rest.data(), rest.size());
+	result.append(rest.data(), decoded_size);
+
+	EXPECT_EQ(result, test_string);
+}
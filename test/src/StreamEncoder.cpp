@@ -0,0 +1,110 @@
+#include <huffman/StreamEncoder.hpp>
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace huffman;
+
+namespace
+{
+
+const std::string test_string = "A" "BB" "CCC" "DDDD" "EEEEE" "FFFFFF" "GGGGGGG";
+
+std::string encode_at_once(HuffmanDictionary& dictionary, const std::string& src)
+{
+	std::string dst(src.size() * 4, 0);
+	auto[src_read, bits_written] = dictionary.encode(src.data(), src.size(), dst.data(), dst.size(), 0);
+	dst.resize((bits_written + 7) / 8);
+
+	return dst;
+}
+
+} // namespace
+
+TEST(StreamEncoder, encode_chunks)
+{
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	const std::string expected = encode_at_once(dictionary, test_string);
+
+	for(size_t chunk_size : {1, 2, 5, 100})
+	{
+		StreamEncoder encoder(dictionary);
+		std::string result;
+
+		for(size_t i = 0; i < test_string.size(); i += chunk_size)
+		{
+			char dst[64];
+			auto[src_read, dst_written] = encoder.encode(test_string.data() + i, std::min(chunk_size, test_string.size() - i), dst, sizeof(dst));
+
+			EXPECT_EQ(src_read, std::min(chunk_size, test_string.size() - i));
+			EXPECT_LT(encoder.pending_bits(), 8);
+			result.append(dst, dst_written);
+		}
+
+		char dst[1];
+		result.append(dst, encoder.finish(dst, sizeof(dst)));
+
+		EXPECT_EQ(encoder.pending_bits(), 0);
+		EXPECT_EQ(result, expected) << "chunk size " << chunk_size;
+	}
+}
+
+TEST(StreamEncoder, encode_small_destination)
+{
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	const std::string expected = encode_at_once(dictionary, test_string);
+	StreamEncoder encoder(dictionary);
+	std::string result;
+
+	// One output byte at a time, the encoder keeps what does not fit
+	size_t src_read = 0;
+	while(src_read < test_string.size())
+	{
+		char dst[1];
+		auto[read, written] = encoder.encode(test_string.data() + src_read, test_string.size() - src_read, dst, sizeof(dst));
+
+		EXPECT_LE(encoder.pending_bits(), 64);
+		src_read += read;
+		result.append(dst, written);
+	}
+
+	while(encoder.pending_bits() > 0)
+	{
+		char dst[1];
+		result.append(dst, encoder.finish(dst, sizeof(dst)));
+	}
+
+	EXPECT_EQ(result, expected);
+}
+
+TEST(StreamEncoder, flush)
+{
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	StreamEncoder encoder(dictionary);
+	char dst[16];
+
+	auto[src_read, dst_written] = encoder.encode(test_string.data(), test_string.size(), dst, 0);
+
+	EXPECT_EQ(dst_written, 0);
+	EXPECT_GE(encoder.pending_bits(), 8);
+
+	size_t pending_bits = encoder.pending_bits();
+	size_t flushed = encoder.flush(dst, sizeof(dst));
+
+	EXPECT_EQ(flushed, pending_bits / 8);
+	EXPECT_EQ(encoder.pending_bits(), pending_bits % 8);
+}
+
+TEST(StreamEncoder, finish_without_space)
+{
+	HuffmanDictionary dictionary(test_string.data(), test_string.size());
+	StreamEncoder encoder(dictionary);
+	char dst[16];
+
+	encoder.encode(test_string.data(), 1, dst, sizeof(dst));
+
+	EXPECT_EQ(encoder.finish(dst, 0), 0);
+	EXPECT_GT(encoder.pending_bits(), 0);
+	EXPECT_EQ(encoder.finish(dst, sizeof(dst)), 1);
+	EXPECT_EQ(encoder.pending_bits(), 0);
+}
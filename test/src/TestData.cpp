@@ -0,0 +1,27 @@
+#include <cstdint>
+
+#include "TestData.hpp"
+
+std::string make_text(size_t size)
+{
+	std::string text;
+	for(size_t i = 0; i < size; i++)
+	{
+		text += static_cast<char>('a' + (i * i) % 23 % 13);
+	}
+
+	return text;
+}
+
+std::string make_random(size_t size)
+{
+	std::string random;
+	uint32_t state = 1;
+	for(size_t i = 0; i < size; i++)
+	{
+		state = state * 1664525 + 1013904223;
+		random += static_cast<char>(state >> 24);
+	}
+
+	return random;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief				text-like data: 13 letters with uneven frequencies
+ */
+[[gnu::abi_tag("cxx11")]] std::string make_text(size_t size);
+
+/**
+ * @brief				pseudo-random bytes that do not compress
+ */
+[[gnu::abi_tag("cxx11")]] std::string make_random(size_t size);
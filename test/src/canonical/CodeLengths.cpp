@@ -0,0 +1,158 @@
+#include "huffman/HuffmanNode.hpp"
+#include <canonical/CodeLengths.hpp>
+#include <gtest/gtest.h>
+
+using namespace huffman::canonical;
+using namespace huffman;
+
+namespace
+{
+
+std::array<size_t, 256> fibonacci_frequencies(size_t count)
+{
+	std::array<size_t, 256> frequencies{};
+	size_t a = 1, b = 1;
+	for(size_t i = 0; i < count; i++)
+	{
+		frequencies[i] = a;
+		b = a + b;
+		a = b - a;
+	}
+
+	return frequencies;
+}
+
+double kraft_sum(const code_lengths& lengths)
+{
+	double sum = 0;
+	for(auto length : lengths)
+	{
+		sum += length ? 1.0 / static_cast<double>(uint64_t{1} << length) : 0;
+	}
+
+	return sum;
+}
+
+size_t cost(const code_lengths& lengths, const std::array<size_t, 256>& frequencies)
+{
+	size_t sum = 0;
+	for(size_t i = 0; i < lengths.size(); i++)
+	{
+		sum += lengths[i] * frequencies[i];
+	}
+
+	return sum;
+}
+
+} // namespace
+
+TEST(canonical_CodeLengths, tree_code_lengths)
+{
+	HuffmanNode root{
+		{'a', 7},
+		{
+			{'b', 3}, {'c', 1}
+		}
+	};
+
+	auto lengths = tree_code_lengths(root);
+
+	EXPECT_EQ(lengths['a'], 1);
+	EXPECT_EQ(lengths['b'], 2);
+	EXPECT_EQ(lengths['c'], 2);
+	EXPECT_EQ(lengths['d'], 0);
+	EXPECT_EQ(tree_depth(root), 2);
+}
+
+TEST(canonical_CodeLengths, limited_unconstrained)
+{
+	std::array<size_t, 256> frequencies{};
+	frequencies['a'] = 7;
+	frequencies['b'] = 3;
+	frequencies['c'] = 1;
+
+	auto lengths = limited_code_lengths(frequencies, 32);
+
+	EXPECT_EQ(lengths['a'], 1);
+	EXPECT_EQ(lengths['b'], 2);
+	EXPECT_EQ(lengths['c'], 2);
+}
+
+TEST(canonical_CodeLengths, limited)
+{
+	auto frequencies = fibonacci_frequencies(30);
+	auto unlimited = limited_code_lengths(frequencies, 32);
+	auto lengths = limited_code_lengths(frequencies, 8);
+
+	EXPECT_EQ(*std::max_element(unlimited.begin(), unlimited.end()), 29);
+	EXPECT_EQ(*std::max_element(lengths.begin(), lengths.end()), 8);
+	EXPECT_EQ(kraft_sum(lengths), 1.0);
+	EXPECT_GT(cost(lengths, frequencies), cost(unlimited, frequencies));
+}
+
+TEST(canonical_CodeLengths, limited_single_byte)
+{
+	std::array<size_t, 256> frequencies{};
+	frequencies['x'] = 5;
+
+	auto lengths = limited_code_lengths(frequencies, 8);
+
+	EXPECT_EQ(kraft_sum(lengths), 0);
+}
+
+TEST(canonical_CodeLengths, limited_too_short)
+{
+	auto frequencies = fibonacci_frequencies(17);
+
+	EXPECT_THROW(limited_code_lengths(frequencies, 4), std::invalid_argument);
+	EXPECT_NO_THROW(limited_code_lengths(frequencies, 5));
+}
+
+TEST(canonical_CodeLengths, canonical_tree)
+{
+	code_lengths lengths{};
+	lengths['a'] = 2;
+	lengths['b'] = 1;
+	lengths['c'] = 2;
+	std::array<size_t, 256> frequencies{};
+	frequencies['b'] = 4;
+
+	// b = 0, a = 10, c = 11 ('1' is the left child)
+	HuffmanTree tree = make_canonical_tree(lengths, frequencies, 0);
+	auto root = tree.root();
+
+	ASSERT_FALSE(tree.is_byte_node(root));
+	EXPECT_EQ(tree.byte(tree.right(root)), 'b');
+	EXPECT_EQ(tree.frequency(tree.right(root)), 4);
+	EXPECT_EQ(tree.byte(tree.right(tree.left(root))), 'a');
+	EXPECT_EQ(tree.byte(tree.left(tree.left(root))), 'c');
+	EXPECT_TRUE(is_canonical(tree));
+}
+
+TEST(canonical_CodeLengths, canonical_tree_single_byte)
+{
+	code_lengths lengths{};
+	std::array<size_t, 256> frequencies{};
+	frequencies['x'] = 3;
+
+	HuffmanTree tree = make_canonical_tree(lengths, frequencies, 'x');
+
+	EXPECT_EQ(tree.node_count(), 1);
+	EXPECT_TRUE(tree.is_byte_node(tree.root()));
+	EXPECT_EQ(tree.byte(tree.root()), 'x');
+	EXPECT_EQ(tree.frequency(tree.root()), 3);
+}
+
+TEST(canonical_CodeLengths, canonical_tree_incomplete)
+{
+	code_lengths lengths{};
+	lengths['a'] = 2;
+	lengths['b'] = 1;
+	std::array<size_t, 256> frequencies{};
+
+	EXPECT_THROW(make_canonical_tree(lengths, frequencies, 0), std::invalid_argument);
+
+	lengths['c'] = 1;
+
+	EXPECT_THROW(make_canonical_tree(lengths, frequencies, 0), std::invalid_argument);
+}
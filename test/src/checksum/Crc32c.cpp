@@ -0,0 +1,86 @@
+#include <checksum/Crc32c.hpp>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace huffman::checksum;
+
+namespace
+{
+
+using crc_function = uint32_t(*)(uint32_t, const char*, size_t);
+
+uint32_t crc32c_reference(const std::vector<char>& data)
+{
+	uint32_t crc = 0xffffffff;
+	for(char c : data)
+	{
+		crc ^= static_cast<unsigned char>(c);
+		for(size_t bit = 0; bit < 8; bit++)
+		{
+			crc = (crc >> 1) ^ (crc & 1 ? 0x82f63b78 : 0);
+		}
+	}
+
+	return ~crc;
+}
+
+std::vector<char> random_bytes(size_t size)
+{
+	std::mt19937 generator{static_cast<unsigned>(size)};
+	std::uniform_int_distribution<int> byte{0, 255};
+
+	std::vector<char> data(size);
+	for(char& c : data)
+	{
+		c = static_cast<char>(byte(generator));
+	}
+
+	return data;
+}
+
+void check_crc(crc_function crc)
+{
+	const char* check = "123456789";
+	EXPECT_EQ(crc(0, check, std::strlen(check)), 0xe3069283);
+	EXPECT_EQ(crc(0, nullptr, 0), 0);
+
+	for(size_t size : {1, 7, 8, 9, 63, 64, 1000, 4099})
+	{
+		auto data = random_bytes(size);
+		EXPECT_EQ(crc(0, data.data(), data.size()), crc32c_reference(data)) << "size " << size;
+
+		// Continue the checksum after a split that is not a multiple of 8
+		size_t split = size / 3;
+		uint32_t running = crc(0, data.data(), split);
+		EXPECT_EQ(crc(running, data.data() + split, size - split), crc32c_reference(data)) << "size " << size;
+	}
+}
+
+} // namespace
+
+TEST(Crc32c, crc32c)
+{
+	check_crc(crc32c);
+}
+
+TEST(Crc32c, crc32c_generic)
+{
+	check_crc(crc32c_generic);
+}
+
+#ifdef HUFFMAN_CHECKSUM_SSE42
+
+TEST(Crc32c, crc32c_sse42)
+{
+	if(!has_sse42())
+	{
+		GTEST_SKIP() << "cpu does not support SSE4.2";
+	}
+
+	check_crc(crc32c_sse42);
+}
+
+#endif
@@ -0,0 +1,49 @@
+#include <decoder/BitReader.hpp>
+#include <gtest/gtest.h>
+
+using namespace huffman::decoder;
+
+TEST(decoder_BitReader, empty)
+{
+	auto object = BitReader(nullptr, 0, 0);
+
+	EXPECT_TRUE(object.empty());
+	EXPECT_EQ(object.bitsProcessed(), 0);
+	EXPECT_EQ(object.peek(0, 11), 0);
+}
+
+TEST(decoder_BitReader, big_offset)
+{
+	char byte = '\xB3';
+	auto object = BitReader(&byte, 1, 9);
+
+	EXPECT_TRUE(object.empty());
+	EXPECT_EQ(object.bitsProcessed(), 8);
+}
+
+TEST(decoder_BitReader, peek)
+{
+	std::string bytes{ '\xAA', '\xBB', '\xCC' };
+	auto object = BitReader(bytes.data(), bytes.size(), 4);
+
+	EXPECT_EQ(object.peek(0, 8), 0xBA);
+	EXPECT_EQ(object.peek(8, 12), 0xCCB);
+	EXPECT_EQ(object.bitsProcessed(), 4);
+	EXPECT_EQ(object.bitsLeft(), 20);
+}
+
+TEST(decoder_BitReader, consume)
+{
+	std::string bytes{ '\xAA', '\xBB', '\xCC' };
+	auto object = BitReader(bytes.data(), bytes.size(), 0);
+
+	object.consume(12);
+
+	EXPECT_EQ(object.peek(0, 4), 0xB);
+	EXPECT_EQ(object.bitsProcessed(), 12);
+
+	object.consume(20);
+
+	EXPECT_TRUE(object.empty());
+	EXPECT_EQ(object.bitsProcessed(), 24);
+}
@@ -0,0 +1,123 @@
+#include "huffman/HuffmanNode.hpp"
+#include <decoder/InterleavedDecoder.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <tuple>
+
+using namespace huffman::decoder;
+using namespace huffman;
+
+namespace
+{
+
+// 'a' is 1, 'b' is 0
+const HuffmanNode root
+{
+	{'a', 1},
+	{'b', 1},
+};
+
+// Every level adds one leaf, so the codes are 1, 2, ..., depth bits long
+HuffmanNode make_deep_tree(size_t depth)
+{
+	HuffmanNode node{static_cast<char>(depth), 1};
+	for(size_t i = depth; i > 0; i--)
+	{
+		node = HuffmanNode{HuffmanNode{static_cast<char>(i-1), 1}, std::move(node)};
+	}
+
+	return node;
+}
+
+} // namespace
+
+TEST(decoder_InterleavedDecoder, decode)
+{
+	const char src[] = {0x0f, 0x55, 0x00, static_cast<char>(0xff)};
+	DecodeTable table(root);
+	InterleavedDecoder decoder({BitReader{src, 1, 0}, BitReader{src+1, 1, 0}, BitReader{src+2, 1, 0}, BitReader{src+3, 1, 0}}, table);
+	std::string dst[4] = {std::string(8, 0), std::string(5, 0), std::string(2, 0), std::string(3, 0)};
+
+	bool complete = decoder.decode({dst[0].data(), dst[1].data(), dst[2].data(), dst[3].data()}, {8, 5, 2, 3});
+
+	EXPECT_TRUE(complete);
+	EXPECT_EQ(dst[0], "aaaabbbb");
+	EXPECT_EQ(dst[1], "ababa");
+	EXPECT_EQ(dst[2], "bb");
+	EXPECT_EQ(dst[3], "aaa");
+}
+
+TEST(decoder_InterleavedDecoder, stream_ends)
+{
+	const char src[] = {0x0f, 0x55, 0x00, static_cast<char>(0xff)};
+	DecodeTable table(root);
+	InterleavedDecoder decoder({BitReader{src, 1, 0}, BitReader{src+1, 1, 0}, BitReader{src+2, 1, 0}, BitReader{src+3, 1, 0}}, table);
+	std::string dst[4] = {std::string(8, 0), std::string(9, 0), std::string(8, 0), std::string(8, 0)};
+
+	bool complete = decoder.decode({dst[0].data(), dst[1].data(), dst[2].data(), dst[3].data()}, {8, 9, 8, 8});
+
+	EXPECT_FALSE(complete);
+	EXPECT_EQ(dst[1].substr(0, 8), "abababab");
+}
+
+TEST(decoder_InterleavedDecoder, fast_path)
+{
+	// Streams of different lengths, so that they reach their last 8 bytes at different points
+	std::array<std::string, 4> src{};
+	uint32_t state = 1;
+	for(size_t stream = 0; stream < src.size(); stream++)
+	{
+		for(size_t i = 0; i < 40 + stream*20; i++)
+		{
+			state = state * 1664525 + 1013904223;
+			src[stream] += static_cast<char>(state >> 24);
+		}
+	}
+
+	// Deeper than the fast path handles (60), and not (40)
+	for(size_t depth : {10, 40, 60})
+	{
+		HuffmanNode root = make_deep_tree(depth);
+		DecodeTable table(root);
+
+		// One code at a time never takes the fast path
+		std::array<std::string, 4> expected{};
+		for(size_t stream = 0; stream < src.size(); stream++)
+		{
+			TableDecoder single(BitReader(src[stream].data(), src[stream].size(), 0), table);
+			for(auto[byte, is_set] = single.decode(); is_set; std::tie(byte, is_set) = single.decode())
+			{
+				expected[stream] += byte;
+			}
+		}
+
+		auto expect_decoded = [&](const std::array<size_t, 4>& sizes)
+		{
+			InterleavedDecoder decoder({
+				BitReader{src[0].data(), src[0].size(), 0},
+				BitReader{src[1].data(), src[1].size(), 0},
+				BitReader{src[2].data(), src[2].size(), 0},
+				BitReader{src[3].data(), src[3].size(), 0},
+			}, table);
+			std::array<std::string, 4> dst{std::string(sizes[0], 0), std::string(sizes[1], 0), std::string(sizes[2], 0), std::string(sizes[3], 0)};
+
+			EXPECT_TRUE(decoder.decode({dst[0].data(), dst[1].data(), dst[2].data(), dst[3].data()}, sizes)) << "depth " << depth << ", size " << sizes[0];
+			for(size_t stream = 0; stream < dst.size(); stream++)
+			{
+				EXPECT_EQ(dst[stream], expected[stream].substr(0, sizes[stream])) << "depth " << depth << ", size " << sizes[0] << ", stream " << stream;
+			}
+		};
+
+		// Stopping at every output size the streams have in common, then at the end of every stream
+		size_t shortest = std::min({expected[0].size(), expected[1].size(), expected[2].size(), expected[3].size()});
+		for(size_t size = 0; size <= shortest; size++)
+		{
+			expect_decoded({size, size, size, size});
+		}
+
+		expect_decoded({expected[0].size(), expected[1].size(), expected[2].size(), expected[3].size()});
+	}
+}
@@ -0,0 +1,54 @@
+#include <decoder/BitReader.hpp>
+#include <decoder/SegmentReader.hpp>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace huffman::decoder;
+
+TEST(decoder_SegmentReader, empty)
+{
+	auto object = SegmentReader({});
+
+	EXPECT_TRUE(object.empty());
+	EXPECT_EQ(object.bitsProcessed(), 0);
+	EXPECT_EQ(object.peek(0, 11), 0);
+
+	object.consume(3);
+	EXPECT_EQ(object.bitsProcessed(), 0);
+}
+
+TEST(decoder_SegmentReader, same_as_bit_reader)
+{
+	std::string bytes;
+	for(size_t i = 0; i < 50; i++)
+	{
+		bytes += static_cast<char>(i * 37 + 11);
+	}
+
+	// Empty segments and segments shorter than a load
+	std::span<const std::byte> all = std::as_bytes(std::span{bytes});
+	std::vector<std::span<const std::byte>> segments{all.subspan(0, 0), all.subspan(0, 1), all.subspan(1, 10), all.subspan(11, 0), all.subspan(11, 3), all.subspan(14)};
+
+	BitReader expected(bytes.data(), bytes.size(), 0);
+	auto object = SegmentReader(segments);
+	EXPECT_EQ(object.maxBits(), bytes.size()*8);
+
+	for(size_t i = 0; !expected.empty(); i++)
+	{
+		size_t skip = i % 9;
+		size_t count = i * 5 % 57 + 1;
+
+		ASSERT_EQ(object.peek(skip, count), expected.peek(skip, count)) << "bit " << expected.bitsProcessed();
+		EXPECT_EQ(object.bitsLeft(), expected.bitsLeft());
+
+		expected.consume(i % 13);
+		object.consume(i % 13);
+	}
+
+	EXPECT_TRUE(object.empty());
+	EXPECT_EQ(object.bitsProcessed(), bytes.size()*8);
+}
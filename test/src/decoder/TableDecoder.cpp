@@ -0,0 +1,158 @@
+#include "huffman/HuffmanNode.hpp"
+#include <decoder/ByteDecoder.hpp>
+#include <decoder/TableDecoder.hpp>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace huffman::decoder;
+using namespace huffman;
+
+namespace
+{
+
+// Every level adds one leaf, so the codes are 1, 2, ..., depth bits long
+HuffmanNode make_deep_tree(size_t depth)
+{
+	HuffmanNode node{static_cast<char>(depth), 1};
+	for(size_t i = depth; i > 0; i--)
+	{
+		node = HuffmanNode{HuffmanNode{static_cast<char>(i-1), 1}, std::move(node)};
+	}
+
+	return node;
+}
+
+} // namespace
+
+TEST(decoder_TableDecoder, decode_null)
+{
+	BitReader reader(nullptr, 0, 0);
+	HuffmanNode root
+	{
+		{'a', 1},
+		{'b', 2},
+	};
+
+	DecodeTable table(root);
+	TableDecoder decoder(reader, table);
+
+	auto[byte, is_set] = decoder.decode();
+
+	EXPECT_FALSE(is_set);
+	EXPECT_EQ(decoder.bitsProcessed(), 0);
+}
+
+TEST(decoder_TableDecoder, single_node)
+{
+	BitReader reader(nullptr, 0, 0);
+	HuffmanNode root{'x', 3};
+
+	DecodeTable table(root);
+	TableDecoder decoder(reader, table);
+
+	auto[byte, is_set] = decoder.decode();
+
+	EXPECT_TRUE(is_set);
+	EXPECT_EQ(byte, 'x');
+	EXPECT_EQ(decoder.bitsProcessed(), 0);
+	EXPECT_EQ(table.rootBits(), 0);
+}
+
+TEST(decoder_TableDecoder, incomplete_code)
+{
+	HuffmanNode root
+	{
+		{'a', 7},
+		{
+			{'b', 3}, {'c', 1}
+		}
+	};
+
+	char byte = '\x7F'; // 7 times 'a' and the first bit of 'b'
+	BitReader reader(&byte, 1, 0);
+	DecodeTable table(root);
+	TableDecoder decoder(reader, table);
+	char dst[8];
+
+	EXPECT_EQ(decoder.decode(dst, sizeof(dst)), 7);
+	EXPECT_EQ(decoder.bitsProcessed(), 7);
+}
+
+TEST(decoder_TableDecoder, sub_tables)
+{
+	const size_t depth = 40;
+	HuffmanNode root = make_deep_tree(depth);
+	DecodeTable table(root);
+
+	EXPECT_EQ(table.rootBits(), DecodeTable::max_root_bits);
+
+	// One code of every length
+	std::string src(depth*(depth+1)/2/8 + 1, '\0');
+	size_t bit = 0;
+	for(size_t i = 0; i < depth; i++)
+	{
+		bit += i;
+		src[bit/8] = static_cast<char>(src[bit/8] | (1 << (bit % 8)));
+		bit++;
+	}
+
+	BitReader reader(src.data(), src.size(), 0);
+	TableDecoder decoder(reader, table);
+
+	ByteLoader loader(src.data(), src.size(), 0);
+	ByteDecoder byte_decoder(loader, root);
+
+	for(size_t i = 0; i < depth; i++)
+	{
+		auto[byte, is_set] = decoder.decode();
+		auto[expected_byte, expected_is_set] = byte_decoder.decode();
+
+		EXPECT_TRUE(is_set);
+		EXPECT_EQ(byte, expected_byte);
+		EXPECT_EQ(byte, static_cast<char>(i));
+		EXPECT_EQ(decoder.bitsProcessed(), byte_decoder.bitsProcessed());
+	}
+}
+
+TEST(decoder_TableDecoder, fast_path)
+{
+	// Deeper than the fast path handles (60), and not (40)
+	for(size_t depth : {10, 40, 60})
+	{
+		HuffmanNode root = make_deep_tree(depth);
+		DecodeTable table(root);
+
+		std::string src;
+		uint32_t state = 1;
+		for(size_t i = 0; i < 100; i++)
+		{
+			state = state * 1664525 + 1013904223;
+			src += static_cast<char>(state >> 24);
+		}
+
+		// One code at a time never takes the fast path
+		std::string expected;
+		std::vector<size_t> bits_processed{0};
+		TableDecoder single(BitReader(src.data(), src.size(), 0), table);
+		for(auto[byte, is_set] = single.decode(); is_set; std::tie(byte, is_set) = single.decode())
+		{
+			expected += byte;
+			bits_processed.push_back(single.bitsProcessed());
+		}
+
+		// Stopping at every output size and at the end of the input, where the fast path hands over to the checked one
+		for(size_t size = 0; size <= expected.size() + 1; size++)
+		{
+			TableDecoder decoder(BitReader(src.data(), src.size(), 0), table);
+			std::string result(size, '\0');
+			size_t written = decoder.decode(result.data(), result.size());
+
+			ASSERT_EQ(written, std::min(size, expected.size())) << "depth " << depth << ", size " << size;
+			EXPECT_EQ(result.substr(0, written), expected.substr(0, written));
+			EXPECT_EQ(decoder.bitsProcessed(), bits_processed[written]);
+		}
+	}
+}
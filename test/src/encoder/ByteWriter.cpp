@@ -36,4 +36,72 @@ TEST(ByteWriter, three_byte_long)
 	EXPECT_EQ(writer.bitsWritten(), 3*8);
 	EXPECT_EQ(writer.maxBits(), sizeof(buffer)*8);
 	EXPECT_FALSE(writer.empty());
-}
\ No newline at end of file
+}
+
+TEST(ByteWriter, content)
+{
+	std::string buffer(32, '\xFF');
+	ByteWriter writer(buffer.data(), buffer.size(), 0);
+
+	for(int i = 0; i < 10; i++)
+	{
+		EXPECT_TRUE(writer.write(0b101, 3));
+		EXPECT_TRUE(writer.write(0xA5A5, 16));
+	}
+	writer.flush();
+
+	// Compare with a bit-by-bit reference
+	std::string expected(24, '\0');
+	const uint64_t code = 0b101 | (0xA5A5 << 3);
+	for(size_t bit = 0; bit < 190; bit++)
+	{
+		expected[bit/8] = static_cast<char>(expected[bit/8] | (((code >> (bit % 19)) & 1) << (bit % 8)));
+	}
+
+	EXPECT_EQ(writer.bitsWritten(), 190);
+	EXPECT_EQ(buffer.substr(0, 24), expected);
+}
+
+TEST(ByteWriter, offset_keeps_written_bits)
+{
+	std::string buffer{'\x05', '\xFF', '\xFF'};
+	ByteWriter writer(buffer.data(), buffer.size(), 11);
+
+	buffer[1] = '\x07';
+
+	EXPECT_TRUE(writer.write(0b11, 2));
+	writer.flush();
+
+	EXPECT_EQ(writer.bitsWritten(), 13);
+	EXPECT_EQ(buffer[0], '\x05');
+	EXPECT_EQ(buffer[1], '\x1F');
+}
+
+TEST(ByteWriter, long_code)
+{
+	std::string buffer(12, '\0');
+	ByteWriter writer(buffer.data(), buffer.size(), 4);
+
+	EXPECT_TRUE(writer.write(0xFFFFFFFFFFFFFFFF, 64));
+	writer.flush();
+
+	EXPECT_EQ(writer.bitsWritten(), 68);
+	EXPECT_EQ(buffer[0], '\xF0');
+	EXPECT_EQ(buffer.substr(1, 7), std::string(7, '\xFF'));
+	EXPECT_EQ(buffer[8], '\x0F');
+	EXPECT_EQ(buffer[9], '\0');
+}
+
+TEST(ByteWriter, not_enough_space)
+{
+	std::string buffer(2, '\0');
+	ByteWriter writer(buffer.data(), buffer.size(), 0);
+
+	EXPECT_TRUE(writer.write(0x1FF, 9));
+	EXPECT_FALSE(writer.write(0xFF, 8));
+	EXPECT_TRUE(writer.write(0x7F, 7));
+	writer.flush();
+
+	EXPECT_TRUE(writer.empty());
+	EXPECT_EQ(buffer, "\xFF\xFF");
+}
@@ -0,0 +1,59 @@
+#include <encoder/ByteWriter.hpp>
+#include <encoder/SegmentWriter.hpp>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace huffman;
+using namespace huffman::encoder;
+
+TEST(SegmentWriter, empty)
+{
+	SegmentWriter writer({});
+
+	EXPECT_FALSE(writer.write(0, 17));
+	writer.flush();
+
+	EXPECT_EQ(writer.bitsWritten(), 0);
+	EXPECT_EQ(writer.maxBits(), 0);
+	EXPECT_TRUE(writer.empty());
+}
+
+TEST(SegmentWriter, same_as_byte_writer)
+{
+	// Segments of 0 to 12 bytes, so codes cross the boundaries and whole words are stored in some of them
+	std::vector<std::byte> buffer(100);
+	std::vector<std::span<std::byte>> segments;
+	for(size_t begin = 0, size = 0; begin < buffer.size(); begin += size, size = (size + 5) % 13)
+	{
+		segments.push_back(std::span{buffer}.subspan(begin, std::min(size, buffer.size() - begin)));
+	}
+
+	std::string expected(buffer.size(), '\0');
+	ByteWriter byte_writer(expected.data(), expected.size(), 0);
+	SegmentWriter writer(segments);
+	EXPECT_EQ(writer.maxBits(), buffer.size()*8);
+
+	for(size_t i = 0; ; i++)
+	{
+		size_t length = i * 7 % 32 + 1;
+		uint64_t code = (i * 0x9e3779b97f4a7c15) & ((uint64_t{1} << length) - 1);
+
+		bool has_space = byte_writer.write(code, length);
+		ASSERT_EQ(writer.write(code, length), has_space);
+		if(!has_space)
+		{
+			break;
+		}
+	}
+
+	byte_writer.flush();
+	writer.flush();
+
+	EXPECT_EQ(writer.bitsWritten(), byte_writer.bitsWritten());
+	EXPECT_EQ(std::string(reinterpret_cast<const char*>(buffer.data()), buffer.size()), expected);
+}
@@ -0,0 +1,120 @@
+#include <histogram/Histogram.hpp>
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+using namespace huffman::histogram;
+
+namespace
+{
+
+using count_function = void(*)(byte_frequencies&, const char*, size_t);
+
+byte_frequencies count_reference(const std::vector<char>& data)
+{
+	byte_frequencies frequencies{};
+	for(char c : data)
+	{
+		frequencies[static_cast<unsigned char>(c)]++;
+	}
+
+	return frequencies;
+}
+
+std::vector<char> random_bytes(size_t size)
+{
+	std::mt19937 generator{static_cast<unsigned>(size)};
+	std::uniform_int_distribution<int> byte{0, 255};
+
+	std::vector<char> data(size);
+	for(char& c : data)
+	{
+		c = static_cast<char>(byte(generator));
+	}
+
+	return data;
+}
+
+std::vector<char> byte_runs(size_t size)
+{
+	std::vector<char> data(size);
+	for(size_t i = 0; i < size; i++)
+	{
+		// Runs of different lengths, some crossing the block boundaries of the kernels
+		data[i] = static_cast<char>((i / 45) % 3 == 0 ? 0x7f : (i * i) / 1000);
+	}
+
+	return data;
+}
+
+void check_count(count_function count_bytes)
+{
+	for(size_t size : {0, 1, 7, 8, 33, 1023, 1024, 1025, 4099, 100000})
+	{
+		for(const auto& data : {random_bytes(size), byte_runs(size)})
+		{
+			byte_frequencies frequencies{};
+			count_bytes(frequencies, data.data(), data.size());
+
+			EXPECT_EQ(frequencies, count_reference(data)) << "size " << size;
+		}
+	}
+}
+
+} // namespace
+
+TEST(Histogram, count)
+{
+	check_count(count);
+}
+
+TEST(Histogram, count_generic)
+{
+	check_count(count_generic);
+}
+
+TEST(Histogram, count_parallel)
+{
+	for(size_t threads : {0, 1, 2, 3, 8})
+	{
+		for(size_t size : {0, 1000, 200000, 1000003})
+		{
+			auto data = random_bytes(size);
+			byte_frequencies frequencies{};
+			count_parallel(frequencies, data.data(), data.size(), threads);
+
+			EXPECT_EQ(frequencies, count_reference(data)) << "threads " << threads << ", size " << size;
+		}
+	}
+}
+
+TEST(Histogram, count_adds_to_frequencies)
+{
+	auto data = random_bytes(5000);
+	auto expected = count_reference(data);
+	for(auto& frequency : expected)
+	{
+		frequency += 3;
+	}
+
+	byte_frequencies frequencies;
+	frequencies.fill(3);
+	count(frequencies, data.data(), data.size());
+
+	EXPECT_EQ(frequencies, expected);
+}
+
+#ifdef HUFFMAN_HISTOGRAM_AVX2
+
+TEST(Histogram, count_avx2)
+{
+	if(!has_avx2())
+	{
+		GTEST_SKIP() << "cpu does not support AVX2";
+	}
+
+	check_count(count_avx2);
+}
+
+#endif